@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Scaling of the k-NN pose classifier with threads and pose samples
+ *
+ * Pose libraries of 1k up to 1M samples are generated in memory from
+ * jittered copies of the shipped pose samples, and the same jittered queries
+ * are classified with 1 to 4 scan threads. The mean classification time per
+ * frame is reported with the speedup over a single thread, and the confidence
+ * of every class must match the single-threaded results on every frame, as
+ * the top-N lists of the threads are merged.
+ *
+ *    knn_scaling_benchmark pose_embeddings.csv [max samples] [frames]
+ *
+ * By default, libraries go up to 1M samples, which take about 1 GB of memory,
+ * and 20 frames are classified for each library and thread count.
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "classifier/pose_classification.h"
+
+static const size_t MAX_THREADS = 4;
+static const size_t WARM_UP_FRAMES = 3;
+static const float JITTER = 0.01; // Relative to the normalized coordinates
+
+struct LandmarkSample {
+  Landmark landmark;
+  int class_id;
+};
+
+/**
+ * Function to load the pose samples, normalized as by PoseClassifier
+ */
+static void load_samples(const char *file, std::vector<LandmarkSample> &samples,
+                         std::vector<std::string> &class_names) {
+  std::ifstream file_in(file);
+  std::string line, word;
+  while (getline(file_in, line)) {
+    std::vector<std::string> row;
+    std::stringstream str(line);
+    while (getline(str, word, ','))
+      row.push_back(word);
+    if (row.size() != 2 + 33 * 3)
+      continue;
+
+    LandmarkSample sample;
+    for (size_t j{0}; j < 33; j++) {
+      sample.landmark[j] = Keypoint(std::stof(row.at(2 + j * 3 + 0)) / 1920.0,
+                                    std::stof(row.at(2 + j * 3 + 1)) / 1080.0,
+                                    std::stof(row.at(2 + j * 3 + 2)) / 1920.0);
+    }
+    sample.class_id = -1;
+    for (size_t i{0}; i < class_names.size(); i++) {
+      if (class_names.at(i) == row.at(1))
+        sample.class_id = i;
+    }
+    if (sample.class_id < 0) {
+      sample.class_id = class_names.size();
+      class_names.push_back(row.at(1));
+    }
+    samples.push_back(sample);
+  }
+}
+
+/**
+ * Function to jitter every keypoint of a landmark
+ */
+static Landmark jitter(const Landmark &landmark, std::mt19937 &generator) {
+  std::uniform_real_distribution<float> noise(-JITTER, JITTER);
+  Landmark jittered = landmark;
+  for (size_t j{0}; j < 33; j++) {
+    Keypoint kp(landmark(j)["x"] + noise(generator),
+                landmark(j)["y"] + noise(generator),
+                landmark(j)["z"] + noise(generator));
+    jittered[j] = kp;
+  }
+  return jittered;
+}
+
+/**
+ * Function to generate a library of jittered pose samples, the same for a
+ * given size
+ */
+static std::vector<PoseSample>
+generate_library(const std::vector<LandmarkSample> &samples,
+                 const std::vector<std::string> &class_names,
+                 const size_t &size) {
+  std::mt19937 generator(1337);
+  std::vector<PoseSample> library;
+  library.reserve(size);
+  for (size_t i{0}; i < size; i++) {
+    const LandmarkSample &sample = samples.at(i % samples.size());
+    library.push_back(PoseSample("sample_" + std::to_string(i),
+                                 class_names.at(sample.class_id),
+                                 sample.class_id,
+                                 jitter(sample.landmark, generator)));
+  }
+  return library;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " pose_embeddings.csv [max samples] [frames]\n";
+    return 1;
+  }
+  size_t max_samples = (argc > 2) ? std::stoul(argv[2]) : 1000000;
+  size_t num_frames = (argc > 3) ? std::stoul(argv[3]) : 20;
+
+  std::vector<LandmarkSample> samples;
+  std::vector<std::string> class_names;
+  load_samples(argv[1], samples, class_names);
+  if (samples.empty()) {
+    std::cerr << "No pose samples in " << argv[1] << "\n";
+    return 1;
+  }
+
+  std::mt19937 generator(42);
+  std::vector<Landmark> queries;
+  for (size_t i{0}; i < WARM_UP_FRAMES + num_frames; i++)
+    queries.push_back(jitter(samples.at(i % samples.size()).landmark,
+                             generator));
+
+  std::cout << "Hardware threads: " << std::thread::hardware_concurrency()
+            << "\n\n"
+            << std::setw(10) << "samples" << std::setw(9) << "threads"
+            << std::setw(12) << "ms/frame" << std::setw(9) << "speedup"
+            << std::setw(9) << "match\n";
+
+  bool all_match = true;
+  for (size_t size{1000}; size <= max_samples; size *= 10) {
+    std::vector<ClassificationResult> reference;
+    double reference_time = 0.0;
+    for (size_t threads{1}; threads <= MAX_THREADS; threads++) {
+      PoseClassifier classifier(generate_library(samples, class_names, size),
+                                class_names, threads);
+
+      std::vector<ClassificationResult> results;
+      double total_time = 0.0;
+      for (size_t i{0}; i < queries.size(); i++) {
+        auto start = std::chrono::steady_clock::now();
+        ClassificationResult result = classifier.classify_pose(queries.at(i));
+        auto end = std::chrono::steady_clock::now();
+        if (i < WARM_UP_FRAMES)
+          continue;
+        total_time += std::chrono::duration<double, std::milli>(end - start)
+                          .count();
+        results.push_back(result);
+      }
+      double frame_time = total_time / num_frames;
+
+      if (threads == 1) {
+        reference = results;
+        reference_time = frame_time;
+      }
+      size_t matches = 0;
+      for (size_t i{0}; i < results.size(); i++) {
+        bool match = true;
+        for (size_t j{0}; j < class_names.size(); j++) {
+          match = match && (results.at(i).get_class_confidence(j) ==
+                            reference.at(i).get_class_confidence(j));
+        }
+        matches += match ? 1 : 0;
+      }
+      all_match = all_match && (matches == results.size());
+
+      std::cout << std::setw(10) << size << std::setw(9)
+                << classifier.get_num_threads() << std::setw(12)
+                << std::fixed << std::setprecision(3) << frame_time
+                << std::setw(8) << std::setprecision(2)
+                << reference_time / frame_time << "x" << std::setw(5)
+                << matches << "/" << results.size() << "\n";
+    }
+  }
+
+  if (!all_match) {
+    std::cerr << "Results differ from the single-threaded scan!\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 NXP
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Script to generate the pose sample distances model of the pose classifier.
+
+The embeddings of the pose samples are baked into the model as a constant.
+The model takes the original and flipped embeddings of a pose [1, 2, 23, 3]
+and returns, for all the samples, the max-abs distance followed by the mean
+distance [1, 2, N], each the smallest of both orientations, as computed by
+PoseClassifier on the CPU. The selection of the nearest samples stays on the
+CPU.
+
+The embeddings are saved by the batch tool, which computes them the same way
+as the application:
+
+    ./imx-smart-fitness-batch --pose-embeddings=pose_embeddings.csv \\
+        --export-embeddings=embeddings.txt
+
+"""
+
+import argparse
+import numpy as np
+import tensorflow as tf
+
+POSE_EMBEDDING_SIZE = 23
+# Weights of the x, y, z axes of the classifier distances
+AXIS_WEIGHTS = np.array([1.0, 1.0, 0.2], dtype=np.float32)
+TOP_N_BY_MAX_DISTANCE = 30
+
+
+def load_embeddings(embeddings_file):
+    embeddings = np.loadtxt(embeddings_file, delimiter=",", dtype=np.float32,
+                            ndmin=2)
+    if embeddings.shape[1] != POSE_EMBEDDING_SIZE * 3:
+        raise SystemExit("Unexpected embeddings in " + embeddings_file)
+    return embeddings.reshape(-1, POSE_EMBEDDING_SIZE, 3)
+
+
+def reference_distances(samples, query):
+    # Same computation as the model, in numpy
+    diff = np.abs(query[0][:, None] - samples[None]) * AXIS_WEIGHTS
+    max_distances = diff.max(axis=(2, 3)).min(axis=0)
+    mean_distances = (diff.sum(axis=(2, 3)) /
+                      (POSE_EMBEDDING_SIZE * 2)).min(axis=0)
+    return np.stack([max_distances, mean_distances])[None]
+
+
+def build_model(samples):
+    num_samples = samples.shape[0]
+    weighted_samples = tf.constant(
+        (samples * AXIS_WEIGHTS).reshape(1, num_samples, -1))
+    weights = tf.constant(np.tile(AXIS_WEIGHTS, POSE_EMBEDDING_SIZE))
+
+    @tf.function(input_signature=[
+        tf.TensorSpec([1, 2, POSE_EMBEDDING_SIZE, 3], tf.float32)])
+    def distances(query):
+        # [2, 1, 69] - [1, N, 69], broadcast over the samples
+        query = tf.reshape(query, [2, 1, POSE_EMBEDDING_SIZE * 3]) * weights
+        diff = tf.abs(query - weighted_samples)
+        max_distances = tf.reduce_min(tf.reduce_max(diff, axis=2), axis=0)
+        mean_distances = tf.reduce_min(
+            tf.reduce_sum(diff, axis=2), axis=0) / (POSE_EMBEDDING_SIZE * 2)
+        return tf.reshape(tf.stack([max_distances, mean_distances]),
+                          [1, 2, num_samples])
+
+    return distances
+
+
+def queries(samples, count, seed=1337):
+    # Pose samples in both orientations, jittered
+    generator = np.random.default_rng(seed)
+    for i in generator.choice(len(samples), count):
+        embedding = samples[i] + generator.uniform(
+            -0.02, 0.02, samples[i].shape).astype(np.float32)
+        flipped = embedding * np.array([-1.0, 1.0, 1.0], dtype=np.float32)
+        yield np.stack([embedding, flipped])[None].astype(np.float32)
+
+
+def check_model(model_file, samples, count):
+    # Runs the model with the CPU TFLite runtime
+    interpreter = tf.lite.Interpreter(model_path=model_file)
+    interpreter.allocate_tensors()
+    input_index = interpreter.get_input_details()[0]["index"]
+    output_index = interpreter.get_output_details()[0]["index"]
+
+    top_n = min(TOP_N_BY_MAX_DISTANCE, len(samples))
+    max_error = 0.0
+    overlap = 0.0
+    for query in queries(samples, count):
+        interpreter.set_tensor(input_index, query)
+        interpreter.invoke()
+        output = interpreter.get_tensor(output_index)
+        reference = reference_distances(samples, query)
+        max_error = max(max_error, float(np.abs(output - reference).max()))
+
+        # Candidates kept by the max distance filter
+        model_top = set(np.argsort(output[0, 0], kind="stable")[:top_n])
+        reference_top = set(np.argsort(reference[0, 0], kind="stable")[:top_n])
+        overlap += len(model_top & reference_top) / top_n
+
+    print("Max distance error: %.6f" % max_error)
+    print("Top-%d overlap with the reference: %.1f%%"
+          % (top_n, overlap / count * 100.0))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    parser.add_argument("embeddings", help="embeddings of the pose samples")
+    parser.add_argument("-o", "--output", default="pose_distances.tflite",
+                        help="generated model")
+    parser.add_argument(
+        "--quantize", action="store_true",
+        help="INT8 model with FLOAT32 input and output, required by the "
+        "Ethos-U NPU of i.MX 93 (compile it with vela)")
+    parser.add_argument(
+        "--check", type=int, default=0, metavar="N",
+        help="compare N queries of the model with the numpy reference")
+    args = parser.parse_args()
+
+    samples = load_embeddings(args.embeddings)
+    distances = build_model(samples)
+
+    converter = tf.lite.TFLiteConverter.from_concrete_functions(
+        [distances.get_concrete_function()])
+    if args.quantize:
+        converter.optimizations = [tf.lite.Optimize.DEFAULT]
+        converter.representative_dataset = lambda: (
+            [query] for query in queries(samples, 200))
+        converter.target_spec.supported_ops = [
+            tf.lite.OpsSet.TFLITE_BUILTINS_INT8]
+        converter.inference_input_type = tf.float32
+        converter.inference_output_type = tf.float32
+
+    with open(args.output, "wb") as model_file:
+        model_file.write(converter.convert())
+    print("Distance model of %d pose samples saved to %s"
+          % (len(samples), args.output))
+
+    if args.check > 0:
+        check_model(args.output, samples, args.check)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 NXP
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Script to strip the unused output heads of pose_landmark_lite.tflite model.
+
+Only the landmarks [1, 195] and the pose score [1, 1] are used by the
+application. The segmentation mask, the heat map and the world landmarks are
+removed from the model outputs, along with the operators, tensors and weights
+that are only needed to compute them, so the NPU does not run these heads.
+
+"""
+
+import argparse
+import numpy as np
+
+from tensorflow.lite.tools import flatbuffer_utils
+
+# Values per landmark: x, y, z, visibility, presence
+NUM_VALUES = 5
+NUM_BODY_LANDMARKS = 33
+
+
+def is_used_output(tensor):
+    # Same matching as PoseLandmarkInterpreter::configure()
+    size = int(np.prod(tensor.shape))
+    if size == 1:
+        return True
+    return (
+        size == tensor.shape[-1]
+        and size % NUM_VALUES == 0
+        and size // NUM_VALUES >= NUM_BODY_LANDMARKS
+    )
+
+
+def tensor_bytes(model, tensor):
+    buffer = model.buffers[tensor.buffer]
+    if buffer.data is not None:
+        return len(buffer.data)
+    # float32 outputs
+    return int(np.prod(tensor.shape)) * 4
+
+
+def prune_subgraph(model, subgraph, keep):
+    # Operators whose outputs are needed, walking the graph backwards
+    needed = set(keep)
+    operators = []
+    for op in reversed(subgraph.operators):
+        if any(int(i) in needed for i in op.outputs):
+            operators.append(op)
+            needed.update(int(i) for i in op.inputs if i >= 0)
+    operators.reverse()
+    removed_ops = len(subgraph.operators) - len(operators)
+
+    # Tensors still referenced, indices are remapped
+    used = set(int(i) for i in subgraph.inputs) | set(keep)
+    for op in operators:
+        used.update(int(i) for i in op.inputs if i >= 0)
+        used.update(int(i) for i in op.outputs if i >= 0)
+        if op.intermediates is not None:
+            used.update(int(i) for i in op.intermediates if i >= 0)
+    remap = {}
+    tensors = []
+    for index, tensor in enumerate(subgraph.tensors):
+        if index in used:
+            remap[index] = len(tensors)
+            tensors.append(tensor)
+
+    def remap_list(indices):
+        return [remap[int(i)] if i >= 0 else -1 for i in indices]
+
+    for op in operators:
+        op.inputs = remap_list(op.inputs)
+        op.outputs = remap_list(op.outputs)
+        if op.intermediates is not None:
+            op.intermediates = remap_list(op.intermediates)
+    subgraph.inputs = remap_list(subgraph.inputs)
+    subgraph.outputs = remap_list(keep)
+    subgraph.operators = operators
+    subgraph.tensors = tensors
+    return remap, removed_ops
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("input", help="pose landmark model (*.tflite)")
+    parser.add_argument(
+        "-o",
+        "--output",
+        help="pruned model, the input model is overwritten by default",
+    )
+    parser.add_argument(
+        "--keep",
+        help="comma separated indices of the outputs to keep, "
+        "landmarks and score by default",
+    )
+    args = parser.parse_args()
+
+    model = flatbuffer_utils.read_model(args.input)
+    subgraph = model.subgraphs[0]
+    outputs = [int(i) for i in subgraph.outputs]
+
+    if args.keep is not None:
+        keep = [outputs[int(i)] for i in args.keep.split(",")]
+    else:
+        keep = [i for i in outputs if is_used_output(subgraph.tensors[i])]
+    if len(keep) == 0:
+        raise SystemExit("No output to keep in " + args.input)
+
+    pruned_outputs = [i for i in outputs if i not in keep]
+    output_bytes = sum(
+        tensor_bytes(model, subgraph.tensors[i]) for i in pruned_outputs
+    )
+    for i in pruned_outputs:
+        tensor = subgraph.tensors[i]
+        print(
+            "Removing output %s %s"
+            % (tensor.name.decode("utf-8"), list(tensor.shape))
+        )
+
+    total_ops = len(subgraph.operators)
+    remap, removed_ops = prune_subgraph(model, subgraph, keep)
+
+    # Signature outputs refer to the tensors of the subgraph
+    if model.signatureDefs is not None:
+        for signature in model.signatureDefs:
+            if signature.subgraphIndex != 0:
+                continue
+            signature.outputs = [
+                output for output in signature.outputs
+                if output.tensorIndex in keep
+            ]
+            for tensor_map in signature.inputs + signature.outputs:
+                tensor_map.tensorIndex = remap[tensor_map.tensorIndex]
+
+    # Weights of the removed heads, buffers of the metadata are kept
+    used_buffers = set()
+    for graph in model.subgraphs:
+        used_buffers.update(tensor.buffer for tensor in graph.tensors)
+    if model.metadata is not None:
+        used_buffers.update(metadata.buffer for metadata in model.metadata)
+    weight_bytes = 0
+    for index, buffer in enumerate(model.buffers):
+        if index not in used_buffers and buffer.data is not None:
+            weight_bytes += len(buffer.data)
+            buffer.data = None
+
+    output_file = args.output if args.output is not None else args.input
+    flatbuffer_utils.write_model(model, output_file)
+
+    print("Operators: %d -> %d" % (total_ops, total_ops - removed_ops))
+    print("Weights removed: %.1f KiB" % (weight_bytes / 1024.0))
+    print("Output data removed per frame: %.1f KiB" % (output_bytes / 1024.0))
+    print("Pruned model saved to " + output_file)
+
+
+if __name__ == "__main__":
+    main()
@@ -190,6 +190,9 @@ tflite_model = converter.convert()
 with open("../pose_landmark_lite_quant.tflite", "wb") as f:
     f.write(tflite_model)    
 '
+
+	# Strip the output heads unused by the application
+	python3 ../prune_outputs.py ../pose_landmark_lite_quant.tflite
 )
 
 conda deactivate
@@ -206,4 +209,4 @@ rm anchors.npy
 # Create deploy folder
 mkdir deploy
 mv *.tflite anchors.txt deploy/
-cp pose_embeddings.csv deploy/
+cp pose_embeddings.csv exercises.csv deploy/
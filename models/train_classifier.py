@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+
+# Copyright 2026 NXP
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Script to train the linear or MLP pose classifier from the pose samples.
+
+The model is trained on the embeddings of the pose samples, saved by the
+batch tool in the order of the pose embeddings file, which holds the class of
+every sample:
+
+    ./imx-smart-fitness-batch --pose-embeddings=pose_embeddings.csv \\
+        --export-embeddings=embeddings.txt
+    python3 train_classifier.py embeddings.txt pose_embeddings.csv
+
+Samples are also used flipped and jittered. The input normalization is
+folded into the first layer, and the model is saved in the CSV format read
+by MlpClassifier (src/classifier/mlp_classifier.h).
+
+"""
+
+import argparse
+import csv
+import numpy as np
+
+POSE_EMBEDDING_SIZE = 23
+NUM_INPUTS = POSE_EMBEDDING_SIZE * 3
+# Flipping the landmark flips the x axis of the embedding
+FLIP = np.tile(np.array([-1.0, 1.0, 1.0], dtype=np.float32),
+               POSE_EMBEDDING_SIZE)
+
+
+def load_samples(embeddings_file, samples_file):
+    embeddings = np.loadtxt(embeddings_file, delimiter=",", dtype=np.float32,
+                            ndmin=2)
+    with open(samples_file) as samples:
+        labels = [row[1] for row in csv.reader(samples) if len(row) > 1]
+    if embeddings.shape != (len(labels), NUM_INPUTS):
+        raise SystemExit("Embeddings do not match the pose samples")
+
+    # Class IDs in order of appearance, as assigned by the k-NN classifier
+    classes = list(dict.fromkeys(labels))
+    targets = np.array([classes.index(label) for label in labels])
+    return embeddings, targets, classes
+
+
+def augment(embeddings, targets, copies, jitter, generator):
+    inputs = [embeddings, embeddings * FLIP]
+    for _ in range(copies):
+        noise = generator.normal(0.0, jitter, embeddings.shape)
+        inputs.append(embeddings * (1.0 + noise))
+        inputs.append(embeddings * (1.0 + noise) * FLIP)
+    return (np.concatenate(inputs).astype(np.float32),
+            np.tile(targets, len(inputs)))
+
+
+def init_layers(sizes, generator):
+    layers = []
+    for inputs, outputs in zip(sizes[:-1], sizes[1:]):
+        weights = generator.normal(0.0, np.sqrt(2.0 / inputs),
+                                   (outputs, inputs)).astype(np.float32)
+        layers.append([weights, np.zeros(outputs, dtype=np.float32)])
+    return layers
+
+
+def forward(layers, inputs):
+    activations = [inputs]
+    for i, (weights, biases) in enumerate(layers):
+        values = activations[-1] @ weights.T + biases
+        if i < len(layers) - 1:
+            values = np.maximum(values, 0.0)
+        activations.append(values)
+    return activations
+
+
+def softmax(logits):
+    exp = np.exp(logits - logits.max(axis=1, keepdims=True))
+    return exp / exp.sum(axis=1, keepdims=True)
+
+
+def train(layers, inputs, targets, num_classes, args):
+    # Full batch Adam on the cross entropy, with weight decay
+    moments = [[np.zeros_like(p), np.zeros_like(p)]
+               for layer in layers for p in layer]
+    one_hot = np.eye(num_classes, dtype=np.float32)[targets]
+    for step in range(1, args.epochs + 1):
+        activations = forward(layers, inputs)
+        gradient = (softmax(activations[-1]) - one_hot) / len(inputs)
+        gradients = []
+        for i in reversed(range(len(layers))):
+            weights = layers[i][0]
+            gradients.insert(0, [gradient.T @ activations[i]
+                                 + args.weight_decay * weights,
+                                 gradient.sum(axis=0)])
+            gradient = (gradient @ weights) * (activations[i] > 0.0)
+
+        parameters = [p for layer in layers for p in layer]
+        flat_gradients = [g for layer in gradients for g in layer]
+        for p, g, m in zip(parameters, flat_gradients, moments):
+            m[0] = 0.9 * m[0] + 0.1 * g
+            m[1] = 0.999 * m[1] + 0.001 * g * g
+            m_hat = m[0] / (1.0 - 0.9 ** step)
+            v_hat = m[1] / (1.0 - 0.999 ** step)
+            p -= args.learning_rate * m_hat / (np.sqrt(v_hat) + 1e-8)
+
+
+def accuracy(layers, inputs, targets):
+    return float(np.mean(forward(layers, inputs)[-1].argmax(axis=1)
+                         == targets))
+
+
+def save_model(output_file, layers, classes, mean, std):
+    # Normalization folded into the first layer
+    weights, biases = layers[0]
+    layers = [[weights / std, biases - (weights / std) @ mean]] + layers[1:]
+    with open(output_file, "w") as model:
+        model.write("classes," + ",".join(classes) + "\n")
+        for i, (weights, biases) in enumerate(layers):
+            activation = "relu" if i < len(layers) - 1 else "linear"
+            model.write("layer,%d,%d,%s\n"
+                        % (weights.shape[1], weights.shape[0], activation))
+            for row, bias in zip(weights, biases):
+                model.write(",".join("%.9g" % w for w in row)
+                            + ",%.9g\n" % bias)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    parser.add_argument("embeddings", help="embeddings of the pose samples")
+    parser.add_argument("samples", help="pose embeddings file (*.csv)")
+    parser.add_argument("-o", "--output", default="pose_classifier.csv",
+                        help="trained model")
+    parser.add_argument("--hidden", type=int, default=32,
+                        help="units of the hidden layer, 0 for a linear "
+                        "model (default: 32)")
+    parser.add_argument("--epochs", type=int, default=500)
+    parser.add_argument("--learning-rate", type=float, default=0.01)
+    parser.add_argument("--weight-decay", type=float, default=1e-4)
+    parser.add_argument("--copies", type=int, default=8,
+                        help="jittered copies of every sample")
+    parser.add_argument("--jitter", type=float, default=0.05,
+                        help="relative noise of the jittered copies")
+    parser.add_argument("--validation", type=float, default=0.2,
+                        help="fraction of the samples held out to report "
+                        "the accuracy, 0 to train on all of them")
+    parser.add_argument("--seed", type=int, default=1337)
+    args = parser.parse_args()
+
+    generator = np.random.default_rng(args.seed)
+    embeddings, targets, classes = load_samples(args.embeddings, args.samples)
+
+    order = generator.permutation(len(targets))
+    num_validation = int(len(targets) * args.validation)
+    validation, training = order[:num_validation], order[num_validation:]
+
+    inputs, labels = augment(embeddings[training], targets[training],
+                             args.copies, args.jitter, generator)
+    mean = inputs.mean(axis=0)
+    std = np.maximum(inputs.std(axis=0), 1e-6)
+
+    sizes = [NUM_INPUTS] + ([args.hidden] if args.hidden > 0 else [])
+    layers = init_layers(sizes + [len(classes)], generator)
+    train(layers, (inputs - mean) / std, labels, len(classes), args)
+
+    print("Classes: " + ", ".join(classes))
+    print("Training accuracy: %.1f%%"
+          % (accuracy(layers, (inputs - mean) / std, labels) * 100.0))
+    if num_validation > 0:
+        inputs, labels = augment(embeddings[validation], targets[validation],
+                                 0, 0.0, generator)
+        print("Validation accuracy: %.1f%%"
+              % (accuracy(layers, (inputs - mean) / std, labels) * 100.0))
+
+    save_model(args.output, layers, classes, mean, std)
+    print("Multiply-accumulates per orientation: %d"
+          % sum(w.size for w, _ in layers))
+    print("Model saved to " + args.output)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,877 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * i.MX Smart Fitness batch analytics
+ *
+ * Re-scores recorded workout videos as fast as possible. Files are
+ * distributed over worker threads, one file per worker at a time, and each
+ * file is processed with its own interpreters, filters, classifier and
+ * repetition counters. Frames are decoded and pushed synchronously through
+ * the pose detection and pose landmark models, so no frame is dropped.
+ *
+ * For every video, per-frame results are written to <name>.csv and
+ * repetition events to <name>_reps.csv in the output directory.
+ *
+ */
+
+#include <glib.h>
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cargs/cargs.h"
+#include "classifier/classification_result.h"
+#include "classifier/distance_model.h"
+#include "classifier/exercise_engine.h"
+#include "classifier/exercise_registry.h"
+#include "classifier/mlp_classifier.h"
+#include "classifier/pose_classification.h"
+#include "mediapipe/pose_detection_interpreter.h"
+#include "mediapipe/pose_landmark_interpreter.h"
+#include "utils/ema_filter.h"
+#include "utils/pose_roi.h"
+#include "utils/tensor_caps.h"
+
+#define WIDTH 640
+#define HEIGHT 480
+
+// Time to wait for an inference result before giving up on a file
+#define INFERENCE_TIMEOUT (10 * GST_SECOND)
+
+/**
+ * Command line options
+ */
+static struct cag_option options[] = {
+    {.identifier = 't',
+     .access_letters = "t",
+     .access_name = "target",
+     .value_name = "i.MX8MP|i.MX93",
+     .description = "Run the models on the NPU of the target (optional, "
+                    "CPU by default)"},
+
+    {.identifier = 'p',
+     .access_letters = "p",
+     .access_name = "pose-detection-model",
+     .value_name = "./path/to/model.tflite",
+     .description = "Path to pose detection TFlite model"},
+
+    {.identifier = 'l',
+     .access_letters = "l",
+     .access_name = "pose-landmark-model",
+     .value_name = "./path/to/model.tflite",
+     .description = "Path to pose landmark TFlite model"},
+
+    {.identifier = 'e',
+     .access_letters = "e",
+     .access_name = "pose-embeddings",
+     .value_name = "./path/to/pose/embeddings.csv",
+     .description = "Path to classification embeddings"},
+
+    {.identifier = 'a',
+     .access_letters = "a",
+     .access_name = "anchors",
+     .value_name = "./path/to/anchors.txt",
+     .description = "Path to anchors file (optional, anchors of the 224x224 "
+                    "pose detection model are built in)"},
+
+    {.identifier = 'x',
+     .access_letters = "x",
+     .access_name = "exercises",
+     .value_name = "./path/to/exercises.csv",
+     .description = "Path to exercises configuration (optional, squats by "
+                    "default, up to 32 pose classes in total)"},
+
+    {.identifier = 'c',
+     .access_letters = "c",
+     .access_name = "classifier",
+     .value_name = "knn|./path/to/classifier.csv",
+     .description = "Pose classifier, k-NN over the pose embeddings or a "
+                    "model trained by train_classifier.py (optional, knn by "
+                    "default)"},
+
+    {.identifier = 'r',
+     .access_letters = "r",
+     .access_name = "compare-classifier",
+     .value_name = NULL,
+     .description = "Report the latency of the trained classifier and its "
+                    "agreement with k-NN on the processed frames"},
+
+    {.identifier = 'v',
+     .access_letters = "v",
+     .access_name = "classifier-precision",
+     .value_name = "float|fp16|int8",
+     .description = "Precision of the pose classifier scan (optional, float "
+                    "by default)"},
+
+    {.identifier = 'y',
+     .access_letters = "y",
+     .access_name = "distance-model",
+     .value_name = "./path/to/model.tflite",
+     .description = "Path to pose sample distances TFlite model, run with "
+                    "the target of the other models (optional)"},
+
+    {.identifier = 'z',
+     .access_letters = "z",
+     .access_name = "export-embeddings",
+     .value_name = "./path/to/embeddings.txt",
+     .description = "Save the embeddings of the pose samples for "
+                    "generate_distance_model.py and exit"},
+
+    {.identifier = 'j',
+     .access_letters = "j",
+     .access_name = "jobs",
+     .value_name = "N",
+     .description = "Number of files processed in parallel (optional, all "
+                    "cores by default)"},
+
+    {.identifier = 'o',
+     .access_letters = "o",
+     .access_name = "output-dir",
+     .value_name = "./path/to/directory",
+     .description = "Directory of the CSV results (optional, current "
+                    "directory by default)"},
+
+    {.identifier = 'h',
+     .access_letters = "h",
+     .access_name = "help",
+     .value_name = NULL,
+     .description = "Shows the command help"}};
+
+/**
+ * Settings shared by all the workers
+ */
+struct BatchConfig {
+  const char *pose_detection_model;
+  const char *pose_landmark_model;
+  const char *pose_embeddings;
+  const char *anchors;
+  const char *exercises;
+  const char *distance_model;
+  const char *classifier_model; // nullptr for k-NN
+  bool compare_classifier;      // With k-NN, when a model is used
+  std::string filter_options; // tensor_filter properties for the target
+  std::string output_dir;
+  QuantizedIndex::Precision precision; // Of the pose classifier scan
+};
+
+/**
+ * Result of one video
+ */
+struct FileResult {
+  bool success;
+  uint64_t frames;
+  double video_seconds;
+  double wall_seconds;
+  // Classifier comparison, raw results of the frames with a visible pose
+  uint64_t compared_frames;
+  uint64_t agreed_frames;
+  double classifier_us;
+  double reference_us;
+};
+
+/**
+ * Pipeline running one model on frames pushed one at a time
+ */
+typedef struct {
+  GstElement *pipeline;
+  GstElement *appsrc;
+  GstElement *appsink;
+  GstElement *videocrop; // Landmark pipeline only
+} InferencePipeline;
+
+/**
+ * Function to collect the video files of a list of files and directories
+ */
+static std::vector<std::string> list_videos(int argc, char *argv[],
+                                            const int &first);
+
+/**
+ * Function to process the videos assigned to one worker
+ */
+static void run_worker(const BatchConfig *config,
+                       const std::vector<std::string> *files,
+                       std::vector<FileResult> *results,
+                       std::atomic<size_t> *next_file);
+
+/**
+ * Function to process one video and write its CSV results
+ */
+static FileResult process_video(const BatchConfig &config,
+                                const std::string &file);
+
+/**
+ * Function to classify a landmark with a classifier and with its reference,
+ * and to add their latency and agreement to the result of the file
+ */
+static void compare_classifiers(EmbeddingClassifier *classifier,
+                                EmbeddingClassifier *reference,
+                                FullBodyPoseEmbedder &pose_embedding,
+                                const Landmark &landmark, FileResult &result);
+
+/**
+ * Function to create an inference pipeline fed by appsrc
+ */
+static bool create_inference_pipeline(InferencePipeline &inference,
+                                      const gchar *description);
+
+/**
+ * Function to push a frame through an inference pipeline and wait for the
+ * output tensors
+ */
+static GstSample *run_inference(InferencePipeline &inference,
+                                GstBuffer *buffer);
+
+/**
+ * Function to release an inference pipeline
+ */
+static void destroy_inference_pipeline(InferencePipeline &inference);
+
+/**
+ * Function to map the output tensor at index of an inference result
+ */
+static bool map_tensor(GstBuffer *buffer, const size_t &index,
+                       GstMemory *&memory, GstMapInfo &info);
+
+/**
+ * Main function that runs the batch analytics
+ */
+int main(int argc, char *argv[]) {
+  char identifier;
+  const char *target = nullptr;
+  const char *jobs = nullptr;
+  const char *export_embeddings = nullptr;
+  BatchConfig config = {nullptr, nullptr, nullptr, nullptr,
+                        nullptr, nullptr, nullptr, false,
+                        "",      ".",     QuantizedIndex::FLOAT};
+  cag_option_context context;
+
+  cag_option_prepare(&context, options, CAG_ARRAY_SIZE(options), argc, argv);
+  while (cag_option_fetch(&context)) {
+    identifier = cag_option_get(&context);
+    switch (identifier) {
+    case 't':
+      target = cag_option_get_value(&context);
+      break;
+    case 'p':
+      config.pose_detection_model = cag_option_get_value(&context);
+      break;
+    case 'l':
+      config.pose_landmark_model = cag_option_get_value(&context);
+      break;
+    case 'e':
+      config.pose_embeddings = cag_option_get_value(&context);
+      break;
+    case 'a':
+      config.anchors = cag_option_get_value(&context);
+      break;
+    case 'x':
+      config.exercises = cag_option_get_value(&context);
+      break;
+    case 'c':
+      if (strcmp(cag_option_get_value(&context), "knn") != 0)
+        config.classifier_model = cag_option_get_value(&context);
+      break;
+    case 'r':
+      config.compare_classifier = true;
+      break;
+    case 'v':
+      if (!QuantizedIndex::parse_precision(cag_option_get_value(&context),
+                                           config.precision)) {
+        std::cerr << "Please provide a valid classifier precision.\n"
+                     "Run \'./imx-smart-fitness-batch --help\' for more "
+                     "information.\n";
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'y':
+      config.distance_model = cag_option_get_value(&context);
+      break;
+    case 'z':
+      export_embeddings = cag_option_get_value(&context);
+      break;
+    case 'j':
+      jobs = cag_option_get_value(&context);
+      break;
+    case 'o':
+      config.output_dir = cag_option_get_value(&context);
+      break;
+    case 'h':
+      printf("Usage: imx-smart-fitness-batch [OPTION]... FILE|DIRECTORY...\n");
+      printf("i.MX Smart Fitness batch analytics of recorded videos.\n\n");
+      cag_option_print(options, CAG_ARRAY_SIZE(options), stdout);
+      return EXIT_SUCCESS;
+    }
+  }
+
+  // Only the pose samples are needed to generate a distance model
+  if (export_embeddings != nullptr && config.pose_embeddings != nullptr) {
+    PoseClassifier classifier(config.pose_embeddings);
+    classifier.save_embeddings(export_embeddings);
+    g_print("Saved the embeddings of %zu pose samples to %s\n",
+            classifier.get_num_samples(), export_embeddings);
+    return EXIT_SUCCESS;
+  }
+
+  // Only k-NN needs the pose embeddings, a comparison runs both
+  bool needs_embeddings =
+      config.classifier_model == nullptr || config.compare_classifier;
+  if (config.pose_detection_model == nullptr ||
+      config.pose_landmark_model == nullptr ||
+      (needs_embeddings && config.pose_embeddings == nullptr)) {
+    std::cerr << "Please provide the models and pose embeddings.\n"
+                 "Run \'./imx-smart-fitness-batch --help\' for more "
+                 "information.\n";
+    return EXIT_FAILURE;
+  }
+
+  // Models run on the NPU of the target, or on a single CPU core per file so
+  // the files are spread over the cores
+  if (target == nullptr) {
+    config.filter_options = "custom=NumThreads:1";
+  } else if (strcmp(target, "i.MX8MP") == 0) {
+    config.filter_options = "accelerator=true:npu "
+                            "custom=Delegate:External,"
+                            "ExtDelegateLib:libvx_delegate.so";
+  } else if (strcmp(target, "i.MX93") == 0) {
+    config.filter_options = "accelerator=true:npu "
+                            "custom=Delegate:External,"
+                            "ExtDelegateLib:libethosu_delegate.so";
+  } else {
+    std::cerr << "Please provide a valid target.\n"
+                 "Run \'./imx-smart-fitness-batch --help\' for more "
+                 "information.\n";
+    return EXIT_FAILURE;
+  }
+
+  size_t num_jobs = std::max(1u, std::thread::hardware_concurrency());
+  if (jobs != nullptr) {
+    if (atoi(jobs) > 0) {
+      num_jobs = atoi(jobs);
+    } else {
+      std::cerr << "Please provide a valid number of jobs.\n"
+                   "Run \'./imx-smart-fitness-batch --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<std::string> files =
+      list_videos(argc, argv, cag_option_get_index(&context));
+  if (files.empty()) {
+    std::cerr << "Please provide the videos to process.\n"
+                 "Run \'./imx-smart-fitness-batch --help\' for more "
+                 "information.\n";
+    return EXIT_FAILURE;
+  }
+  std::filesystem::create_directories(config.output_dir);
+
+  gst_init(&argc, &argv);
+
+  // Workers take the next file until all files are processed
+  auto start = std::chrono::steady_clock::now();
+  std::vector<FileResult> results(files.size());
+  std::atomic<size_t> next_file{0};
+  std::vector<std::thread> workers;
+  num_jobs = std::min(num_jobs, files.size());
+  for (size_t i{0}; i < num_jobs; i++)
+    workers.push_back(
+        std::thread(run_worker, &config, &files, &results, &next_file));
+  for (size_t i{0}; i < workers.size(); i++)
+    workers.at(i).join();
+  double wall_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+  // Throughput in video seconds processed per wall second
+  double video_seconds = 0.0;
+  uint64_t frames = 0;
+  size_t failed = 0;
+  for (size_t i{0}; i < results.size(); i++) {
+    video_seconds += results.at(i).video_seconds;
+    frames += results.at(i).frames;
+    if (!results.at(i).success)
+      failed++;
+  }
+  g_print("Processed %zu files with %zu jobs: %" G_GUINT64_FORMAT " frames, "
+          "%.1f s of video in %.1f s (%.2f video-s/s)\n",
+          files.size() - failed, num_jobs, frames, video_seconds,
+          wall_seconds, video_seconds / wall_seconds);
+
+  uint64_t compared_frames = 0;
+  uint64_t agreed_frames = 0;
+  double classifier_us = 0.0;
+  double reference_us = 0.0;
+  for (size_t i{0}; i < results.size(); i++) {
+    compared_frames += results.at(i).compared_frames;
+    agreed_frames += results.at(i).agreed_frames;
+    classifier_us += results.at(i).classifier_us;
+    reference_us += results.at(i).reference_us;
+  }
+  if (compared_frames > 0) {
+    g_print("Classifier comparison on %" G_GUINT64_FORMAT " frames: %.1f%% "
+            "agreement with knn, %.1f us per frame against %.1f us for "
+            "knn\n",
+            compared_frames, 100.0 * agreed_frames / compared_frames,
+            classifier_us / compared_frames, reference_us / compared_frames);
+  }
+
+  if (failed > 0) {
+    g_printerr("%zu files failed\n", failed);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Function to collect the video files of a list of files and directories
+ */
+static std::vector<std::string> list_videos(int argc, char *argv[],
+                                            const int &first) {
+  const std::vector<std::string> extensions = {".mp4", ".mkv", ".avi",
+                                               ".mov", ".webm"};
+  std::vector<std::string> files;
+  for (int i = first; i < argc; i++) {
+    std::filesystem::path path(argv[i]);
+    if (!std::filesystem::is_directory(path)) {
+      files.push_back(path.string());
+      continue;
+    }
+
+    // Videos of a directory are processed in name order
+    std::vector<std::string> directory_files;
+    for (const auto &entry : std::filesystem::directory_iterator(path)) {
+      std::string extension = entry.path().extension().string();
+      std::transform(extension.begin(), extension.end(), extension.begin(),
+                     ::tolower);
+      if (entry.is_regular_file() &&
+          std::find(extensions.begin(), extensions.end(), extension) !=
+              extensions.end())
+        directory_files.push_back(entry.path().string());
+    }
+    std::sort(directory_files.begin(), directory_files.end());
+    files.insert(files.end(), directory_files.begin(), directory_files.end());
+  }
+  return files;
+}
+
+/**
+ * Function to process the videos assigned to one worker
+ */
+static void run_worker(const BatchConfig *config,
+                       const std::vector<std::string> *files,
+                       std::vector<FileResult> *results,
+                       std::atomic<size_t> *next_file) {
+  size_t index;
+  while ((index = (*next_file)++) < files->size()) {
+    FileResult result = process_video(*config, files->at(index));
+    results->at(index) = result;
+    if (result.success) {
+      g_print("%s: %" G_GUINT64_FORMAT " frames, %.1f s of video in %.1f s "
+              "(%.2f video-s/s)\n",
+              files->at(index).c_str(), result.frames, result.video_seconds,
+              result.wall_seconds, result.video_seconds / result.wall_seconds);
+      if (result.compared_frames > 0) {
+        g_print("%s: %.1f%% agreement with knn, %.1f us per frame against "
+                "%.1f us for knn\n",
+                files->at(index).c_str(),
+                100.0 * result.agreed_frames / result.compared_frames,
+                result.classifier_us / result.compared_frames,
+                result.reference_us / result.compared_frames);
+      }
+    } else {
+      g_printerr("%s: failed\n", files->at(index).c_str());
+    }
+  }
+}
+
+/**
+ * Function to process one video and write its CSV results
+ */
+static FileResult process_video(const BatchConfig &config,
+                                const std::string &file) {
+  FileResult result = {false, 0, 0.0, 0.0, 0, 0, 0.0, 0.0};
+  auto start = std::chrono::steady_clock::now();
+
+  // Frames are padded to a square before pose detection, as in the live
+  // application
+  Keypoint padded_size(std::max(WIDTH, HEIGHT), std::max(WIDTH, HEIGHT));
+
+  // Decoding runs ahead of the inferences, up to a few frames
+  gchar *decoder_cmd =
+      g_strdup_printf("filesrc name=source ! decodebin ! videoconvert ! "
+                      "videoscale ! "
+                      "video/x-raw,width=%d,height=%d,format=RGB,"
+                      "pixel-aspect-ratio=1/1 ! "
+                      "appsink name=frames sync=false max-buffers=4",
+                      WIDTH, HEIGHT);
+  GstElement *decoder = gst_parse_launch(decoder_cmd, NULL);
+  g_free(decoder_cmd);
+  GstElement *source = gst_bin_get_by_name(GST_BIN(decoder), "source");
+  g_object_set(G_OBJECT(source), "location", file.c_str(), NULL);
+  gst_object_unref(source);
+  GstElement *frames = gst_bin_get_by_name(GST_BIN(decoder), "frames");
+
+  InferencePipeline detection = {};
+  gchar *detection_cmd = g_strdup_printf(
+      "appsrc name=source format=time "
+      "caps=video/x-raw,width=%d,height=%d,format=RGB,framerate=0/1,"
+      "pixel-aspect-ratio=1/1 ! "
+      "videobox autocrop=false bottom=%d right=%d ! "
+      "videoscale ! video/x-raw,width=224,height=224 ! "
+      "tensor_converter ! "
+      "tensor_transform mode=arithmetic "
+      "option=typecast:float32,div:255.0,add:-0.5,mul:2.0 ! "
+      "tensor_filter framework=tensorflow-lite model=%s %s ! "
+      "appsink name=sink sync=false",
+      WIDTH, HEIGHT, HEIGHT - (int)padded_size["y"],
+      WIDTH - (int)padded_size["x"], config.pose_detection_model,
+      config.filter_options.c_str());
+
+  InferencePipeline landmark = {};
+  gchar *landmark_cmd = g_strdup_printf(
+      "appsrc name=source format=time "
+      "caps=video/x-raw,width=%d,height=%d,format=RGB,framerate=0/1,"
+      "pixel-aspect-ratio=1/1 ! "
+      "videocrop name=crop ! "
+      "videoscale ! video/x-raw,width=256,height=256 ! "
+      "tensor_converter ! "
+      "tensor_transform mode=arithmetic option=typecast:float32,div:255.0 ! "
+      "tensor_filter framework=tensorflow-lite model=%s %s ! "
+      "appsink name=sink sync=false",
+      WIDTH, HEIGHT, config.pose_landmark_model,
+      config.filter_options.c_str());
+
+  bool created = create_inference_pipeline(detection, detection_cmd) &&
+                 create_inference_pipeline(landmark, landmark_cmd);
+  g_free(detection_cmd);
+  g_free(landmark_cmd);
+
+  // Every file has its own models state, filters and counters
+  PoseDetectionInterpreter detection_interpreter(config.anchors);
+  PoseLandmarkInterpreter landmark_interpreter;
+  Filter filter;
+  std::unique_ptr<PoseClassifier> knn_classifier;
+  if (config.classifier_model == nullptr || config.compare_classifier) {
+    knn_classifier.reset(
+        new PoseClassifier(config.pose_embeddings, 1, config.precision));
+    if (config.distance_model != nullptr) {
+      knn_classifier->set_distance_model(
+          new DistanceModel(config.distance_model, config.filter_options,
+                            knn_classifier->get_num_samples()));
+    }
+  }
+  std::unique_ptr<MlpClassifier> mlp_classifier;
+  if (config.classifier_model != nullptr)
+    mlp_classifier.reset(new MlpClassifier(config.classifier_model));
+  EmbeddingClassifier *classifier =
+      mlp_classifier ? static_cast<EmbeddingClassifier *>(mlp_classifier.get())
+                     : knn_classifier.get();
+  // Raw results of the model are compared with k-NN
+  EmbeddingClassifier *reference =
+      (mlp_classifier && config.compare_classifier) ? knn_classifier.get()
+                                                    : nullptr;
+  FullBodyPoseEmbedder pose_embedding;
+
+  ExerciseRegistry registry = (config.exercises != nullptr)
+                                  ? ExerciseRegistry(config.exercises)
+                                  : ExerciseRegistry();
+  ExerciseEngine engine(classifier, registry);
+
+  std::string name = std::filesystem::path(file).stem().string();
+  std::ofstream frames_csv(config.output_dir + "/" + name + ".csv");
+  std::ofstream reps_csv(config.output_dir + "/" + name + "_reps.csv");
+
+  // Columns: frame, time, pose region, landmarks in frame pixels, smoothed
+  // class confidences and repetitions of every exercise
+  frames_csv << "frame,timestamp_ms,pose_present,landmark_score,"
+                "roi_xmin,roi_ymin,roi_xmax,roi_ymax";
+  for (size_t i{0}; i < 33; i++)
+    frames_csv << ",lm" << i << "_x,lm" << i << "_y,lm" << i << "_z";
+  for (size_t i{0}; i < classifier->get_num_classes(); i++)
+    frames_csv << ",confidence_" << classifier->get_class_name(i);
+  for (size_t i{0}; i < engine.size(); i++)
+    frames_csv << ",reps_" << engine.get_exercise(i).name;
+  frames_csv << "\n";
+  reps_csv << "timestamp_ms,exercise,repetitions\n";
+
+  std::vector<int> repetitions(engine.size(), 0);
+  GstClockTime first_time = GST_CLOCK_TIME_NONE;
+  GstClockTime end_time = 0;
+  bool failed = !created || !frames_csv.is_open() || !reps_csv.is_open();
+
+  if (!failed)
+    gst_element_set_state(decoder, GST_STATE_PLAYING);
+
+  GstSample *sample;
+  while (!failed &&
+         (sample = gst_app_sink_pull_sample(GST_APP_SINK(frames))) != NULL) {
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    GstClockTime timestamp = GST_BUFFER_PTS(buffer);
+    if (!GST_CLOCK_TIME_IS_VALID(first_time))
+      first_time = timestamp;
+    end_time = timestamp;
+    if (GST_BUFFER_DURATION_IS_VALID(buffer))
+      end_time += GST_BUFFER_DURATION(buffer);
+
+    // Pose detection
+    GstSample *tensors = run_inference(detection, buffer);
+    if (tensors == NULL) {
+      failed = true;
+      gst_sample_unref(sample);
+      break;
+    }
+    if (!detection_interpreter.is_configured()) {
+      std::vector<TensorSpec> outputs;
+      get_tensor_specs(gst_sample_get_caps(tensors), outputs);
+      if (!detection_interpreter.configure(outputs, 224))
+        exit(-1);
+    }
+    GstMemory *memory_scores, *memory_boxes;
+    GstMapInfo info_scores, info_boxes;
+    GstBuffer *tensors_buffer = gst_sample_get_buffer(tensors);
+    if (map_tensor(tensors_buffer, detection_interpreter.get_scores_index(),
+                   memory_scores, info_scores)) {
+      if (map_tensor(tensors_buffer, detection_interpreter.get_boxes_index(),
+                     memory_boxes, info_boxes)) {
+        detection_interpreter.decode_predictions(
+            (float *)info_boxes.data, (float *)info_scores.data);
+        gst_memory_unmap(memory_boxes, &info_boxes);
+      }
+      gst_memory_unmap(memory_scores, &info_scores);
+    }
+    gst_sample_unref(tensors);
+
+    // Pose landmarks on the filtered pose region
+    BoundingBox roi;
+    bool pose_present = get_pose_roi(
+        detection_interpreter.get_pose_detections(), padded_size, WIDTH,
+        HEIGHT, roi);
+    if (pose_present) {
+      roi = filter.filter(roi);
+      pose_present = is_roi_inside(roi, WIDTH, HEIGHT);
+    }
+
+    // Pose is present when the landmark score passes the threshold
+    float score = 0.0;
+    if (pose_present) {
+      g_object_set(G_OBJECT(landmark.videocrop), "left", (int)roi("xmin"),
+                   "top", (int)roi("ymin"), "right",
+                   WIDTH - (int)roi("xmax"), "bottom",
+                   HEIGHT - (int)roi("ymax"), NULL);
+      tensors = run_inference(landmark, buffer);
+      if (tensors == NULL) {
+        failed = true;
+        gst_sample_unref(sample);
+        break;
+      }
+      if (!landmark_interpreter.is_configured()) {
+        std::vector<TensorSpec> outputs;
+        get_tensor_specs(gst_sample_get_caps(tensors), outputs);
+        if (!landmark_interpreter.configure(outputs, 256))
+          exit(-1);
+      }
+      GstMemory *memory_landmarks, *memory_score;
+      GstMapInfo info_landmarks, info_score;
+      tensors_buffer = gst_sample_get_buffer(tensors);
+      pose_present = false;
+      if (map_tensor(tensors_buffer, landmark_interpreter.get_score_index(),
+                     memory_score, info_score)) {
+        if (map_tensor(tensors_buffer,
+                       landmark_interpreter.get_landmarks_index(),
+                       memory_landmarks, info_landmarks)) {
+          score = *(float *)info_score.data;
+          pose_present = landmark_interpreter.decode_predictions(
+              (float *)info_landmarks.data, score);
+          gst_memory_unmap(memory_landmarks, &info_landmarks);
+        }
+        gst_memory_unmap(memory_score, &info_score);
+      }
+      gst_sample_unref(tensors);
+    }
+
+    // Classification and counting, as for every displayed frame live
+    Landmark landmark_result = landmark_interpreter.get_pose_landmark();
+    ClassificationResult classification;
+    if (pose_present && engine.is_visible(landmark_result)) {
+      Landmark filtered = filter.filter(landmark_result);
+      classification = engine.classify(filtered);
+      if (reference != nullptr) {
+        compare_classifiers(classifier, reference, pose_embedding, filtered,
+                            result);
+      }
+    } else {
+      classification = engine.classify_empty();
+    }
+    engine.count(classification);
+
+    double timestamp_ms = (timestamp - first_time) / 1e6;
+    frames_csv << result.frames << "," << timestamp_ms << "," << pose_present
+               << "," << score << "," << roi("xmin") << "," << roi("ymin")
+               << "," << roi("xmax") << "," << roi("ymax");
+    float roi_width = roi("xmax") - roi("xmin");
+    float roi_height = roi("ymax") - roi("ymin");
+    for (size_t i{0}; i < 33; i++) {
+      Keypoint keypoint = landmark_result(i);
+      if (pose_present) {
+        frames_csv << "," << keypoint["x"] * roi_width + roi("xmin") << ","
+                   << keypoint["y"] * roi_height + roi("ymin") << ","
+                   << keypoint["z"] * roi_width;
+      } else {
+        frames_csv << ",,,";
+      }
+    }
+    for (size_t i{0}; i < classifier->get_num_classes(); i++)
+      frames_csv << "," << classification.get_class_confidence(i);
+    for (size_t i{0}; i < engine.size(); i++) {
+      int reps = engine.get_repetitions(i);
+      frames_csv << "," << reps;
+      if (reps > repetitions.at(i)) {
+        reps_csv << timestamp_ms << "," << engine.get_exercise(i).name << ","
+                 << reps << "\n";
+      }
+      repetitions.at(i) = reps;
+    }
+    frames_csv << "\n";
+
+    result.frames++;
+    gst_sample_unref(sample);
+  }
+
+  // Decoding errors end the stream early
+  GstBus *bus = gst_element_get_bus(decoder);
+  GstMessage *message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+  if (message != NULL) {
+    GError *error = NULL;
+    gst_message_parse_error(message, &error, NULL);
+    g_printerr("%s: %s\n", file.c_str(), error->message);
+    g_error_free(error);
+    gst_message_unref(message);
+    failed = true;
+  }
+  gst_object_unref(bus);
+
+  gst_element_set_state(decoder, GST_STATE_NULL);
+  gst_object_unref(frames);
+  gst_object_unref(decoder);
+  destroy_inference_pipeline(detection);
+  destroy_inference_pipeline(landmark);
+
+  result.success = !failed;
+  if (GST_CLOCK_TIME_IS_VALID(first_time))
+    result.video_seconds = (double)(end_time - first_time) / GST_SECOND;
+  result.wall_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  return result;
+}
+
+/**
+ * Function to classify a landmark with a classifier and with its reference,
+ * and to add their latency and agreement to the result of the file
+ */
+static void compare_classifiers(EmbeddingClassifier *classifier,
+                                EmbeddingClassifier *reference,
+                                FullBodyPoseEmbedder &pose_embedding,
+                                const Landmark &landmark, FileResult &result) {
+  PoseEmbedding embeddings = pose_embedding.get_embedding(landmark);
+  PoseEmbedding flipped_embeddings =
+      pose_embedding.get_embedding(PoseClassifier::flip_landmark(landmark));
+
+  auto start = std::chrono::steady_clock::now();
+  int class_id = classifier->classify_embedding(embeddings, flipped_embeddings)
+                     .get_max_confidence_class();
+  auto middle = std::chrono::steady_clock::now();
+  int reference_id =
+      reference->classify_embedding(embeddings, flipped_embeddings)
+          .get_max_confidence_class();
+  auto end = std::chrono::steady_clock::now();
+
+  result.classifier_us +=
+      std::chrono::duration<double, std::micro>(middle - start).count();
+  result.reference_us +=
+      std::chrono::duration<double, std::micro>(end - middle).count();
+  result.compared_frames++;
+
+  // Classes are matched by name, IDs are assigned by each classifier
+  if (class_id < 0 || reference_id < 0) {
+    result.agreed_frames += (class_id == reference_id);
+  } else {
+    result.agreed_frames += (classifier->get_class_name(class_id) ==
+                             reference->get_class_name(reference_id));
+  }
+}
+
+/**
+ * Function to create an inference pipeline fed by appsrc
+ */
+static bool create_inference_pipeline(InferencePipeline &inference,
+                                      const gchar *description) {
+  GError *error = NULL;
+  inference.pipeline = gst_parse_launch(description, &error);
+  if (inference.pipeline == NULL) {
+    g_printerr("Failed to create inference pipeline: %s\n", error->message);
+    g_error_free(error);
+    return false;
+  }
+  inference.appsrc = gst_bin_get_by_name(GST_BIN(inference.pipeline), "source");
+  inference.appsink = gst_bin_get_by_name(GST_BIN(inference.pipeline), "sink");
+  inference.videocrop =
+      gst_bin_get_by_name(GST_BIN(inference.pipeline), "crop");
+  gst_element_set_state(inference.pipeline, GST_STATE_PLAYING);
+  return true;
+}
+
+/**
+ * Function to push a frame through an inference pipeline and wait for the
+ * output tensors
+ */
+static GstSample *run_inference(InferencePipeline &inference,
+                                GstBuffer *buffer) {
+  if (gst_app_src_push_buffer(GST_APP_SRC(inference.appsrc),
+                              gst_buffer_ref(buffer)) != GST_FLOW_OK) {
+    g_printerr("Failed to push frame to inference\n");
+    return NULL;
+  }
+  GstSample *sample = gst_app_sink_try_pull_sample(
+      GST_APP_SINK(inference.appsink), INFERENCE_TIMEOUT);
+  if (sample == NULL)
+    g_printerr("No inference result\n");
+  return sample;
+}
+
+/**
+ * Function to release an inference pipeline
+ */
+static void destroy_inference_pipeline(InferencePipeline &inference) {
+  if (inference.pipeline == NULL)
+    return;
+  gst_element_set_state(inference.pipeline, GST_STATE_NULL);
+  gst_object_unref(inference.appsrc);
+  gst_object_unref(inference.appsink);
+  if (inference.videocrop != NULL)
+    gst_object_unref(inference.videocrop);
+  gst_object_unref(inference.pipeline);
+  inference.pipeline = NULL;
+}
+
+/**
+ * Function to map the output tensor at index of an inference result
+ */
+static bool map_tensor(GstBuffer *buffer, const size_t &index,
+                       GstMemory *&memory, GstMapInfo &info) {
+  if (index >= gst_buffer_n_memory(buffer))
+    return false;
+  memory = gst_buffer_peek_memory(buffer, index);
+  return memory != NULL && gst_memory_map(memory, &info, GST_MAP_READ);
+}
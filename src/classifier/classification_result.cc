@@ -28,60 +28,37 @@
 
 #include "classification_result.h"
 
-ClassificationResult::ClassificationResult() : class_confidences{} {
-  // class_confidences[]
-}
+ClassificationResult::ClassificationResult() : class_confidences{} {}
 
-float ClassificationResult::get_class_confidence(
-    const std::string &class_name) {
-  return (class_confidences.find(class_name) == class_confidences.end())
-             ? 0
-             : class_confidences.at(class_name);
+float ClassificationResult::get_class_confidence(const int &class_id) const {
+  if (class_id < 0 || static_cast<size_t>(class_id) >= MAX_CLASSES)
+    return 0;
+  return class_confidences[class_id];
 }
 
-std::string ClassificationResult::get_max_confidence_class() {
-  std::map<std::string, float>::iterator iterator_map;
+int ClassificationResult::get_max_confidence_class() const {
   float max_confidence = 0;
-  std::string key_class = "";
-  for (iterator_map = class_confidences.begin();
-       iterator_map != class_confidences.end(); iterator_map++) {
-    // "first" tiene la clave. "second" el valor
-    std::string key = iterator_map->first;
-    int value = iterator_map->second;
-    if (value > max_confidence) {
-      max_confidence = value;
-      key_class = key;
+  int class_id = -1;
+  for (size_t i{0}; i < MAX_CLASSES; i++) {
+    if (class_confidences[i] > max_confidence) {
+      max_confidence = class_confidences[i];
+      class_id = i;
     }
   }
-  return key_class;
+  return class_id;
 }
 
-void ClassificationResult::increment_class_confidence(
-    const std::string &class_name) {
-  class_confidences[class_name] =
-      (class_confidences.find(class_name) == class_confidences.end())
-          ? 1
-          : class_confidences.at(class_name) + 1;
+void ClassificationResult::increment_class_confidence(const int &class_id) {
+  if (class_id < 0 || static_cast<size_t>(class_id) >= MAX_CLASSES)
+    return;
+  class_confidences[class_id] += 1;
 }
 
-void ClassificationResult::put_class_confidence(const std::string &class_name,
+void ClassificationResult::put_class_confidence(const int &class_id,
                                                 const float &confidence) {
-  class_confidences[class_name] = confidence;
-}
-
-std::vector<std::string> ClassificationResult::getKeys() {
-  std::map<std::string, float>::iterator iterator_map;
-  std::vector<std::string> keys;
-  for (iterator_map = class_confidences.begin();
-       iterator_map != class_confidences.end(); iterator_map++) {
-    keys.push_back(iterator_map->first);
-  }
-  return keys;
+  if (class_id < 0 || static_cast<size_t>(class_id) >= MAX_CLASSES)
+    return;
+  class_confidences[class_id] = confidence;
 }
 
-bool ClassificationResult::has_key(const std::string &key) {
-  if (class_confidences.find(key) == class_confidences.end()) {
-    return false;
-  }
-  return true;
-}
+void ClassificationResult::clear() { class_confidences.fill(0.0); }
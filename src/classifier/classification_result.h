@@ -28,22 +28,29 @@
 
 #pragma once
 
-#include <iostream>
-#include <map>
-#include <string>
-#include <vector>
+#include <array>
+#include <cstddef>
 
+/**
+ * Class confidences indexed by the integer class ID assigned by the pose
+ * classifier when the pose samples are loaded. Confidences are stored in a
+ * fixed-size dense array, so results can be copied and updated every frame
+ * without heap allocations. The array holds the up and down classes of a
+ * circuit of 16 exercises.
+ */
 class ClassificationResult {
-  std::map<std::string, float> class_confidences;
+public:
+  static const size_t MAX_CLASSES = 32;
+
+private:
+  std::array<float, MAX_CLASSES> class_confidences;
 
 public:
   ClassificationResult();
 
-  float get_class_confidence(const std::string &class_name);
-  std::string get_max_confidence_class();
-  void increment_class_confidence(const std::string &class_name);
-  void put_class_confidence(const std::string &class_name,
-                            const float &confidence);
-  std::vector<std::string> getKeys();
-  bool has_key(const std::string &key);
+  float get_class_confidence(const int &class_id) const;
+  int get_max_confidence_class() const;
+  void increment_class_confidence(const int &class_id);
+  void put_class_confidence(const int &class_id, const float &confidence);
+  void clear();
 };
@@ -28,30 +28,31 @@
 
 #include "classification_smoothing.h"
 
-EMAFilter::EMAFilter() : window_size{10}, alpha{0.2}, data() {}
+EMAFilter::EMAFilter() : alpha{0.2}, data{}, head{0}, size{0} {}
 
-ClassificationResult EMAFilter::filter(ClassificationResult &detection) {
-  data.insert(data.begin(), detection);
-  if (data.size() > window_size) {
-    data.pop_back();
+ClassificationResult EMAFilter::filter(const ClassificationResult &detection) {
+  head = (head + WINDOW_SIZE - 1) % WINDOW_SIZE;
+  data[head] = detection;
+  if (size < WINDOW_SIZE) {
+    size++;
   }
 
-  std::vector<std::string> keys = detection.getKeys();
-
   ClassificationResult smoothed_data;
-  for (size_t i{0}; i < keys.size(); i++) {
+  for (size_t i{0}; i < ClassificationResult::MAX_CLASSES; i++) {
+    // Only classes voted in the latest detection are smoothed
+    if (detection.get_class_confidence(i) <= 0)
+      continue;
+
     float factor = 1.0;
     float top_sum = 0.0;
     float bottom_sum = 0.0;
-    for (size_t j{0}; j < data.size(); j++) {
-      float confidence = 0.0;
-      if (data.at(j).has_key(keys.at(i)))
-        confidence = (data.at(j)).get_class_confidence(keys.at(i));
-      top_sum += factor * confidence;
+    for (size_t j{0}; j < size; j++) {
+      const ClassificationResult &result = data[(head + j) % WINDOW_SIZE];
+      top_sum += factor * result.get_class_confidence(i);
       bottom_sum += factor;
       factor *= (1.0 - alpha);
     }
-    smoothed_data.put_class_confidence(keys.at(i), top_sum / bottom_sum);
+    smoothed_data.put_class_confidence(i, top_sum / bottom_sum);
   }
   return smoothed_data;
 }
@@ -28,16 +28,21 @@
 
 #pragma once
 
-#include <vector>
+#include <array>
 
 #include "classification_result.h"
 
 class EMAFilter {
-  size_t window_size;
+  static const size_t WINDOW_SIZE = 10;
+
   float alpha;
-  std::vector<ClassificationResult> data;
+
+  // Ring buffer with the latest results, head is the newest one
+  std::array<ClassificationResult, WINDOW_SIZE> data;
+  size_t head;
+  size_t size;
 
 public:
   EMAFilter();
-  ClassificationResult filter(ClassificationResult &detection);
+  ClassificationResult filter(const ClassificationResult &detection);
 };
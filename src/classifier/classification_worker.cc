@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Asynchronous classification worker
+ *
+ */
+
+#include "classification_worker.h"
+
+ClassificationWorker::ClassificationWorker(ExerciseEngine *engine,
+                                           Filter *filter_landmark)
+    : engine{engine}, filter_landmark{filter_landmark},
+      thread_policy{nullptr}, queue{}, events{}, thread{}, running{false},
+      latest{}, no_pose_timestamp{0}, processed_frames{0}, dropped_frames{0},
+      stale_frames{0}, gated_frames{0}, dropped_events{0},
+      repetitions{new std::atomic<int>[engine->size()]} {
+  latest.pose_detected = false;
+  latest.capture_timestamp = 0;
+  latest.timestamp = 0;
+  latest.active_exercise = engine->get_active_exercise();
+  for (size_t i{0}; i < engine->size(); i++)
+    repetitions[i] = engine->get_repetitions(i);
+}
+
+ClassificationWorker::~ClassificationWorker() { stop(); }
+
+void ClassificationWorker::set_thread_policy(ThreadPolicy *policy) {
+  thread_policy = policy;
+}
+
+void ClassificationWorker::start() {
+  if (running)
+    return;
+  running = true;
+  thread = std::thread(&ClassificationWorker::run, this);
+}
+
+void ClassificationWorker::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running)
+      return;
+    running = false;
+  }
+  condition.notify_one();
+  if (thread.joinable())
+    thread.join();
+}
+
+bool ClassificationWorker::submit(const Landmark &landmark,
+                                  const bool &pose_detected) {
+  LandmarkFrame frame;
+  frame.landmark = landmark;
+  frame.pose_detected = pose_detected;
+  frame.timestamp = now();
+
+  if (!queue.push(frame)) {
+    dropped_frames++;
+    return false;
+  }
+
+  // Lock so the notification cannot be lost between the check and the wait
+  { std::lock_guard<std::mutex> lock(mutex); }
+  condition.notify_one();
+  return true;
+}
+
+void ClassificationWorker::submit_no_pose() {
+  // An unhandled frame without pose is replaced by the newer one
+  if (no_pose_timestamp.exchange(now()) != 0)
+    stale_frames++;
+
+  { std::lock_guard<std::mutex> lock(mutex); }
+  condition.notify_one();
+}
+
+void ClassificationWorker::run() {
+  LandmarkFrame frame;
+  LandmarkFrame newest;
+  int64_t last_timestamp = 0;
+
+  if (thread_policy != nullptr)
+    thread_policy->enter("classification");
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this] {
+        return !running || !queue.empty() || no_pose_timestamp != 0;
+      });
+      if (!running)
+        break;
+    }
+
+    // Only the newest frame is classified, older ones are stale
+    int64_t no_pose = no_pose_timestamp.exchange(0);
+    bool has_frame = false;
+    while (queue.pop(frame)) {
+      if (has_frame)
+        stale_frames++;
+      newest = frame;
+      has_frame = true;
+    }
+
+    if (no_pose != 0) {
+      if (!has_frame || newest.timestamp < no_pose) {
+        if (has_frame)
+          stale_frames++;
+        newest.landmark = Landmark();
+        newest.pose_detected = false;
+        newest.timestamp = no_pose;
+        has_frame = true;
+      } else {
+        stale_frames++;
+      }
+    }
+
+    // Frames of both producers are not ordered, so older ones are stale
+    if (has_frame && newest.timestamp < last_timestamp) {
+      stale_frames++;
+      has_frame = false;
+    }
+
+    if (has_frame) {
+      last_timestamp = newest.timestamp;
+      process(newest);
+    }
+  }
+
+  if (thread_policy != nullptr)
+    thread_policy->leave();
+}
+
+void ClassificationWorker::process(LandmarkFrame &frame) {
+  ClassificationFrame output;
+  output.capture_timestamp = frame.timestamp;
+
+  // Landmarks without the keypoints of the exercise would only feed the
+  // counter with unreliable poses
+  if (frame.pose_detected && !engine->is_visible(frame.landmark)) {
+    frame.pose_detected = false;
+    gated_frames++;
+  }
+  output.pose_detected = frame.pose_detected;
+
+  if (frame.pose_detected) {
+    output.landmark = filter_landmark->filter(frame.landmark);
+    output.result = engine->classify(output.landmark);
+  } else {
+    output.landmark = frame.landmark;
+    output.result = engine->classify_empty();
+  }
+  count(output);
+  output.active_exercise = engine->get_active_exercise();
+  output.timestamp = now();
+
+  {
+    std::lock_guard<std::mutex> lock(result_mutex);
+    latest = output;
+  }
+  processed_frames++;
+}
+
+void ClassificationWorker::count(const ClassificationFrame &output) {
+  engine->count(output.result);
+
+  // Counts restart after the target repetitions, so any change is an event
+  for (size_t i{0}; i < engine->size(); i++) {
+    int reps = engine->get_repetitions(i);
+    if (reps == repetitions[i])
+      continue;
+    repetitions[i] = reps;
+
+    RepetitionEvent event;
+    event.exercise = i;
+    event.repetitions = reps;
+    event.timestamp = output.capture_timestamp;
+    if (!events.push(event))
+      dropped_events++;
+  }
+}
+
+ClassificationFrame ClassificationWorker::get_latest() {
+  std::lock_guard<std::mutex> lock(result_mutex);
+  return latest;
+}
+
+bool ClassificationWorker::pop_event(RepetitionEvent &event) {
+  return events.pop(event);
+}
+
+int ClassificationWorker::get_repetitions(const size_t &exercise) const {
+  return repetitions[exercise];
+}
+
+uint64_t ClassificationWorker::get_processed_frames() const {
+  return processed_frames;
+}
+
+uint64_t ClassificationWorker::get_dropped_frames() const {
+  return dropped_frames;
+}
+
+uint64_t ClassificationWorker::get_stale_frames() const { return stale_frames; }
+
+uint64_t ClassificationWorker::get_gated_frames() const { return gated_frames; }
+
+uint64_t ClassificationWorker::get_dropped_events() const {
+  return dropped_events;
+}
+
+int64_t ClassificationWorker::now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Asynchronous classification worker
+ *
+ * Decoded landmarks are handed over from the tensor_sink streaming thread
+ * through a bounded single-producer/single-consumer queue to a dedicated
+ * thread that filters and classifies them, so the streaming thread is never
+ * blocked by the k-NN scan. When the worker falls behind, the producer drops
+ * frames on a full queue and the worker skips stale frames to process only
+ * the newest one. Results are published with their timestamps.
+ *
+ * Frames without pose are found by another streaming thread, so they do not
+ * go through the queue: only the time of the latest one is stored in an
+ * atomic, and the worker handles it as a frame without pose when it is newer
+ * than the queued landmarks.
+ *
+ * Landmarks below the score threshold or without the keypoints needed by the
+ * active exercise are gated before the filtering and the k-NN scan, and
+ * handled as frames without pose.
+ *
+ * Repetitions are counted by the worker on every classified frame, so the
+ * counts do not depend on the display. Every change of a count is emitted as
+ * a timestamped event on a second lock-free queue, to be consumed by one
+ * other thread.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../utils/ema_filter.h"
+#include "../utils/spsc_queue.h"
+#include "../utils/thread_policy.h"
+#include "classification_result.h"
+#include "exercise_engine.h"
+
+/**
+ * Landmark handed over to the worker
+ */
+struct LandmarkFrame {
+  Landmark landmark;
+  bool pose_detected;
+  int64_t timestamp; // Time the landmark was decoded (us)
+};
+
+/**
+ * Result published by the worker
+ */
+struct ClassificationFrame {
+  Landmark landmark;           // Filtered landmark
+  ClassificationResult result; // Smoothed classification result
+  bool pose_detected;
+  int64_t capture_timestamp; // Time the landmark was decoded (us)
+  int64_t timestamp;         // Time the result was published (us)
+  size_t active_exercise;    // Exercise whose pose classes are recognized
+};
+
+/**
+ * Change of the repetitions count of an exercise
+ */
+struct RepetitionEvent {
+  size_t exercise;   // Index of the exercise in the engine
+  int repetitions;   // Repetitions of the current set
+  int64_t timestamp; // Time the counted landmark was decoded (us)
+};
+
+class ClassificationWorker {
+  static const size_t QUEUE_SIZE = 4;
+  static const size_t EVENT_QUEUE_SIZE = 64;
+
+  ExerciseEngine *engine;
+  Filter *filter_landmark;
+  ThreadPolicy *thread_policy;
+
+  SpscQueue<LandmarkFrame, QUEUE_SIZE> queue;
+  SpscQueue<RepetitionEvent, EVENT_QUEUE_SIZE> events;
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool running;
+
+  std::mutex result_mutex;
+  ClassificationFrame latest;
+
+  // Time of the latest frame without pose not yet handled, 0 if none
+  std::atomic<int64_t> no_pose_timestamp;
+
+  std::atomic<uint64_t> processed_frames;
+  std::atomic<uint64_t> dropped_frames;
+  std::atomic<uint64_t> stale_frames;
+  std::atomic<uint64_t> gated_frames;
+  std::atomic<uint64_t> dropped_events;
+
+  // Counts written by the worker, read by any thread
+  std::unique_ptr<std::atomic<int>[]> repetitions;
+
+  void run();
+  void process(LandmarkFrame &frame);
+  void count(const ClassificationFrame &output);
+
+public:
+  ClassificationWorker(ExerciseEngine *engine, Filter *filter_landmark);
+  ~ClassificationWorker();
+
+  // Policy applied to the worker thread as stage "classification"
+  void set_thread_policy(ThreadPolicy *policy);
+
+  void start();
+  void stop();
+
+  // Called from the producer thread, returns false if the frame was dropped
+  bool submit(const Landmark &landmark, const bool &pose_detected);
+  // Called from any other thread when a frame has no pose to decode
+  void submit_no_pose();
+  ClassificationFrame get_latest();
+
+  // Called from the consumer thread, returns false if there is no event
+  bool pop_event(RepetitionEvent &event);
+  int get_repetitions(const size_t &exercise) const;
+
+  uint64_t get_processed_frames() const;
+  uint64_t get_dropped_frames() const;
+  uint64_t get_stale_frames() const;
+  uint64_t get_gated_frames() const;
+  uint64_t get_dropped_events() const;
+
+  // Monotonic time in microseconds
+  static int64_t now();
+};
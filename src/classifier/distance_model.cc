@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pose sample distances computed by a TFLite model
+ *
+ */
+
+#include "distance_model.h"
+
+DistanceModel::DistanceModel(const char *model_file,
+                             const std::string &filter_options,
+                             const size_t &num_samples)
+    : pipeline{NULL}, appsrc{NULL}, appsink{NULL}, pool{NULL},
+      num_samples{num_samples},
+      distances(2 * num_samples), failures{0}, sequence{0} {
+  gchar *description = g_strdup_printf(
+      "appsrc name=source format=time "
+      "caps=other/tensors,num_tensors=1,format=static,"
+      "dimensions=3:%zu:2:1,types=float32,framerate=0/1 ! "
+      "tensor_filter framework=tensorflow-lite model=%s %s ! "
+      "appsink name=sink sync=false max-buffers=1 drop=true",
+      POSE_EMBEDDING_SIZE, model_file, filter_options.c_str());
+
+  GError *error = NULL;
+  pipeline = gst_parse_launch(description, &error);
+  g_free(description);
+  if (pipeline == NULL) {
+    std::cerr << "Failed to create distance model pipeline: "
+              << error->message << "\n";
+    g_error_free(error);
+    failures = MAX_FAILURES;
+    return;
+  }
+  appsrc = gst_bin_get_by_name(GST_BIN(pipeline), "source");
+  appsink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+
+  pool = gst_buffer_pool_new();
+  GstStructure *config = gst_buffer_pool_get_config(pool);
+  gst_buffer_pool_config_set_params(config, NULL, QUERY_SIZE, 2, 0);
+  gst_buffer_pool_set_config(pool, config);
+  gst_buffer_pool_set_active(pool, TRUE);
+
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+  // First inference checks that the model has as many samples as loaded,
+  // their distances are checked by PoseClassifier
+  std::vector<float> query(QUERY_SIZE / sizeof(float), 0.0);
+  if (!run(query.data(), FIRST_TIMEOUT)) {
+    std::cerr << "Distance model " << model_file
+              << " does not match the number of pose samples, distances are "
+                 "computed on the CPU!\n";
+    failures = MAX_FAILURES;
+  }
+}
+
+DistanceModel::~DistanceModel() {
+  if (pipeline == NULL)
+    return;
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_buffer_pool_set_active(pool, FALSE);
+  gst_object_unref(pool);
+  gst_object_unref(appsrc);
+  gst_object_unref(appsink);
+  gst_object_unref(pipeline);
+}
+
+bool DistanceModel::is_enabled() const { return failures < MAX_FAILURES; }
+
+bool DistanceModel::run(const float *query, const GstClockTime &timeout) {
+  GstBuffer *buffer = NULL;
+  if (gst_buffer_pool_acquire_buffer(pool, &buffer, NULL) != GST_FLOW_OK)
+    return false;
+  gst_buffer_fill(buffer, 0, query, QUERY_SIZE);
+  GST_BUFFER_OFFSET(buffer) = ++sequence;
+  if (gst_app_src_push_buffer(GST_APP_SRC(appsrc), buffer) != GST_FLOW_OK)
+    return false;
+
+  // Results of previous queries that timed out may still come first
+  gint64 deadline = g_get_monotonic_time() + timeout / GST_USECOND;
+  GstSample *sample = NULL;
+  while (sample == NULL) {
+    gint64 remaining = deadline - g_get_monotonic_time();
+    if (remaining <= 0)
+      return false;
+    sample = gst_app_sink_try_pull_sample(GST_APP_SINK(appsink),
+                                          remaining * GST_USECOND);
+    if (sample == NULL)
+      return false;
+    if (GST_BUFFER_OFFSET(gst_sample_get_buffer(sample)) != sequence) {
+      gst_sample_unref(sample);
+      sample = NULL;
+    }
+  }
+
+  // Single output tensor, max distances followed by mean distances
+  GstBuffer *output = gst_sample_get_buffer(sample);
+  gsize distances_size = 2 * num_samples * sizeof(float);
+  bool valid = (gst_buffer_get_size(output) == distances_size) &&
+               (gst_buffer_extract(output, 0, distances.data(),
+                                   distances_size) ==
+                distances_size);
+  gst_sample_unref(sample);
+  return valid;
+}
+
+bool DistanceModel::compute(
+    const PoseEmbedding &embeddings, const PoseEmbedding &flipped_embeddings,
+    std::vector<std::pair<size_t, float>> &max_distances,
+    std::vector<float> &mean_distances) {
+  if (!is_enabled())
+    return false;
+
+  float query[2 * POSE_EMBEDDING_SIZE * 3];
+  for (size_t j{0}; j < POSE_EMBEDDING_SIZE; j++) {
+    for (size_t k{0}; k < 3; k++) {
+      const char *axis = (k == 0) ? "x" : ((k == 1) ? "y" : "z");
+      query[j * 3 + k] = embeddings[j][axis];
+      query[(POSE_EMBEDDING_SIZE + j) * 3 + k] = flipped_embeddings[j][axis];
+    }
+  }
+
+  if (!run(query, TIMEOUT)) {
+    if (++failures == MAX_FAILURES)
+      std::cerr << "Distance model failed, distances are computed on the "
+                   "CPU!\n";
+    return false;
+  }
+  failures = 0;
+
+  for (size_t i{0}; i < num_samples; i++)
+    max_distances[i] = std::pair<size_t, float>(i, distances[i]);
+  mean_distances.assign(distances.begin() + num_samples, distances.end());
+  return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pose sample distances computed by a TFLite model
+ *
+ * The pose samples are baked into a model generated by
+ * models/generate_distance_model.py, which takes both orientations of the
+ * pose embedding as input ([1, 2, 23, 3] float32) and returns the max and
+ * mean distances to all the samples ([1, 2, N] float32). The model runs in
+ * its own pipeline, fed by appsrc, through a tensor_filter with the same
+ * delegate options as the pose models, so the NPU computes the distances
+ * between the pose inferences. The top-N selection stays on the CPU.
+ *
+ * When the model does not answer in time, the caller falls back to the CPU
+ * distances, and the model is disabled after a few failures in a row. Every
+ * query carries a sequence number in its buffer offset, which tensor_filter
+ * copies to its output, so late results of timed out queries are dropped.
+ *
+ */
+
+#pragma once
+
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pose_embedding.h"
+
+class DistanceModel {
+  static const int MAX_FAILURES = 3;
+  static const gsize QUERY_SIZE = 2 * POSE_EMBEDDING_SIZE * 3 * sizeof(float);
+  static const GstClockTime TIMEOUT = 100 * GST_MSECOND;
+  // The delegate compiles the graph on the first inference
+  static const GstClockTime FIRST_TIMEOUT = 30 * GST_SECOND;
+
+  GstElement *pipeline;
+  GstElement *appsrc;
+  GstElement *appsink;
+  GstBufferPool *pool; // Query buffers, recycled once the model ran
+  size_t num_samples;
+  std::vector<float> distances; // Max distances followed by mean distances
+  int failures;                 // Consecutive failures
+  guint64 sequence;             // Offset of the last query
+
+  bool run(const float *query, const GstClockTime &timeout);
+
+public:
+  // filter_options are the tensor_filter properties of the delegate
+  DistanceModel(const char *model_file, const std::string &filter_options,
+                const size_t &num_samples);
+  ~DistanceModel();
+
+  bool is_enabled() const;
+
+  // Fill the max distances of all the samples, with their index, and the
+  // mean distances. Returns false if the model gave no result.
+  bool compute(const PoseEmbedding &embeddings,
+               const PoseEmbedding &flipped_embeddings,
+               std::vector<std::pair<size_t, float>> &max_distances,
+               std::vector<float> &mean_distances);
+};
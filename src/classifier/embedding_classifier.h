@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pose classifier interface
+ *
+ * A classifier takes the pose embedding of a landmark, with the embedding of
+ * the flipped landmark, and returns the confidence of each pose class. The
+ * confidences are on the scale of the k-NN votes (0 to 10), which the
+ * thresholds of the repetition counters are set for. Class IDs are assigned
+ * when the classifier is loaded, and are resolved by name by the exercise
+ * engine.
+ *
+ * Backends:
+ *
+ *  - PoseClassifier: k-NN over the pose samples of the embeddings file.
+ *  - MlpClassifier: linear or MLP model trained offline from the same file,
+ *    with a fixed cost per frame.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "classification_result.h"
+#include "pose_embedding.h"
+
+class EmbeddingClassifier {
+public:
+  // Total confidence of a result, the number of nearest samples of k-NN
+  static constexpr float MAX_CONFIDENCE = 10.0;
+
+  virtual ~EmbeddingClassifier() {}
+
+  virtual ClassificationResult
+  classify_embedding(const PoseEmbedding &embeddings,
+                     const PoseEmbedding &flipped_embeddings) = 0;
+
+  virtual int get_class_id(const std::string &class_name) const = 0;
+  virtual const std::string &get_class_name(const int &class_id) const = 0;
+  virtual size_t get_num_classes() const = 0;
+  // Name of the backend, for logs and reports
+  virtual const char *get_backend_name() const = 0;
+};
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-exercise engine
+ *
+ */
+
+#include "exercise_engine.h"
+
+ExerciseEngine::ExerciseEngine(EmbeddingClassifier *classifier,
+                               const ExerciseRegistry &registry)
+    : classifier{classifier}, pose_embedding{}, filter_classification{},
+      exercises{registry.get_exercises()}, counters{}, active_exercise{0} {
+  for (size_t i{0}; i < exercises.size(); i++) {
+    Exercise &exercise = exercises.at(i);
+    exercise.up_class_id = classifier->get_class_id(exercise.up_class);
+    exercise.down_class_id = classifier->get_class_id(exercise.down_class);
+    if (exercise.up_class_id < 0 || exercise.down_class_id < 0) {
+      std::cerr << "Pose classes of exercise '" << exercise.name
+                << "' not found in pose embeddings!\n";
+      exit(-1);
+    }
+
+    counters.push_back(RepetitionCounter(
+        exercise.down_class_id, exercise.enter_threshold,
+        exercise.exit_threshold, exercise.target_reps));
+  }
+}
+
+bool ExerciseEngine::is_visible(const Landmark &landmark) const {
+  const std::vector<int> &joints = exercises.at(active_exercise).joints;
+  if (joints.empty())
+    return true;
+
+  float visibility = 0.0;
+  for (size_t i{0}; i < joints.size(); i++)
+    visibility += landmark.get_visibility(joints.at(i));
+  return visibility / joints.size() >= MIN_VISIBILITY;
+}
+
+ClassificationResult ExerciseEngine::classify(const Landmark &landmark) {
+  // Embedding is shared by all the exercises
+  PoseEmbedding embeddings = pose_embedding.get_embedding(landmark);
+  PoseEmbedding flipped_embeddings =
+      pose_embedding.get_embedding(PoseClassifier::flip_landmark(landmark));
+
+  ClassificationResult result =
+      classifier->classify_embedding(embeddings, flipped_embeddings);
+  return filter_classification.filter(result);
+}
+
+ClassificationResult ExerciseEngine::classify_empty() {
+  ClassificationResult empty;
+  return filter_classification.filter(empty);
+}
+
+void ExerciseEngine::count(const ClassificationResult &result) {
+  for (size_t i{0}; i < counters.size(); i++)
+    counters.at(i).count(result);
+
+  update_active_exercise(result);
+}
+
+void ExerciseEngine::update_active_exercise(
+    const ClassificationResult &result) {
+  // Active exercise is the one whose pose classes are the most confident.
+  // Keep the previous one when no exercise pose is recognized.
+  float max_confidence = 0.0;
+  for (size_t i{0}; i < exercises.size(); i++) {
+    float confidence =
+        result.get_class_confidence(exercises.at(i).up_class_id) +
+        result.get_class_confidence(exercises.at(i).down_class_id);
+    if (confidence > max_confidence) {
+      max_confidence = confidence;
+      active_exercise = i;
+    }
+  }
+}
+
+size_t ExerciseEngine::size() const { return exercises.size(); }
+
+size_t ExerciseEngine::get_active_exercise() const { return active_exercise; }
+
+const Exercise &ExerciseEngine::get_exercise(const size_t &index) const {
+  return exercises.at(index);
+}
+
+int ExerciseEngine::get_repetitions(const size_t &index) const {
+  return counters.at(index).get_repetitions();
+}
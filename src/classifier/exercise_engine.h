@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-exercise engine
+ *
+ * The pose embedding is computed once per landmark frame and classified once
+ * against the whole pose library, which holds the samples of every registered
+ * exercise. The smoothed classification result then feeds the repetition
+ * counter of each exercise, so the per-frame cost does not grow with the
+ * number of exercises in the circuit.
+ *
+ * Landmarks whose keypoints needed by the active exercise are not visible
+ * enough are not worth classifying, they are handled as frames without pose.
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "classification_result.h"
+#include "classification_smoothing.h"
+#include "embedding_classifier.h"
+#include "exercise_registry.h"
+#include "pose_classification.h"
+#include "pose_embedding.h"
+#include "repetition_counter.h"
+
+class ExerciseEngine {
+  // Minimum mean visibility of the keypoints needed by the active exercise
+  static constexpr float MIN_VISIBILITY = 0.5;
+
+  EmbeddingClassifier *classifier;
+  FullBodyPoseEmbedder pose_embedding;
+  EMAFilter filter_classification;
+
+  std::vector<Exercise> exercises;
+  std::vector<RepetitionCounter> counters;
+  size_t active_exercise;
+
+  void update_active_exercise(const ClassificationResult &result);
+
+public:
+  ExerciseEngine(EmbeddingClassifier *classifier,
+                 const ExerciseRegistry &registry);
+
+  // Returns true if the keypoints needed by the active exercise are visible
+  bool is_visible(const Landmark &landmark) const;
+
+  // Classify a new landmark and return the smoothed result
+  ClassificationResult classify(const Landmark &landmark);
+  // Smooth an empty result when no landmark is available
+  ClassificationResult classify_empty();
+
+  // Update the repetition counters of all exercises
+  void count(const ClassificationResult &result);
+
+  size_t size() const;
+  size_t get_active_exercise() const;
+  const Exercise &get_exercise(const size_t &index) const;
+  int get_repetitions(const size_t &index) const;
+};
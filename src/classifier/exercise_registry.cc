@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Registry of the fitness exercises tracked by the application
+ *
+ */
+
+#include "exercise_registry.h"
+
+#include <stdexcept>
+
+const char *ExerciseRegistry::DEFAULT_JOINTS =
+    "left_hip;right_hip;left_knee;right_knee;left_ankle;right_ankle";
+
+std::vector<int> ExerciseRegistry::parse_joints(const std::string &joints) {
+  std::vector<int> indices;
+  std::string name;
+  std::stringstream str(joints);
+  while (getline(str, name, ';')) {
+    if (name.empty())
+      continue;
+    int index = Landmark::get_index(name);
+    if (index < 0) {
+      std::cerr << "Unknown keypoint '" << name << "' in exercise joints!\n";
+      exit(-1);
+    }
+    indices.push_back(index);
+  }
+  return indices;
+}
+
+ExerciseRegistry::ExerciseRegistry() : exercises{} {
+  exercises.push_back({"squats",
+                       "Squat",
+                       "squats_up",
+                       "squats_down",
+                       8,
+                       2,
+                       12,
+                       parse_joints(DEFAULT_JOINTS),
+                       -1,
+                       -1});
+}
+
+ExerciseRegistry::ExerciseRegistry(const char *exercises_file) : exercises{} {
+  std::ifstream file_in;
+  std::string line, word;
+  std::vector<std::string> row;
+
+  file_in.open(exercises_file, std::ios::in);
+  if (!file_in.is_open()) {
+    std::cerr << "Failed to open " << exercises_file << "!\n";
+    exit(-1);
+  }
+
+  while (getline(file_in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    row.clear();
+    std::stringstream str(line);
+    while (getline(str, word, ','))
+      row.push_back(word);
+
+    if (row.size() != 7 && row.size() != 8) {
+      std::cerr << "Malformed exercise definition: " << line << "\n";
+      exit(-1);
+    }
+
+    int thresholds[3];
+    try {
+      for (size_t i{0}; i < 3; i++)
+        thresholds[i] = std::stoi(row.at(4 + i));
+    } catch (const std::exception &) {
+      std::cerr << "Invalid exercise definition in " << exercises_file << ": "
+                << line << "\n";
+      exit(-1);
+    }
+
+    Exercise exercise{row.at(0),
+                      row.at(1),
+                      row.at(2),
+                      row.at(3),
+                      thresholds[0],
+                      thresholds[1],
+                      thresholds[2],
+                      parse_joints(row.size() == 8 ? row.at(7)
+                                                   : DEFAULT_JOINTS),
+                      -1,
+                      -1};
+    exercises.push_back(exercise);
+  }
+  file_in.close();
+
+  if (exercises.empty()) {
+    std::cerr << "No exercises defined in " << exercises_file << "!\n";
+    exit(-1);
+  }
+}
+
+size_t ExerciseRegistry::size() const { return exercises.size(); }
+
+const Exercise &ExerciseRegistry::at(const size_t &index) const {
+  return exercises.at(index);
+}
+
+const std::vector<Exercise> &ExerciseRegistry::get_exercises() const {
+  return exercises;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Registry of the fitness exercises tracked by the application
+ *
+ * Each exercise is described by the two pose classes of the k-NN classifier
+ * that delimit one repetition, the thresholds used by the repetition counter
+ * and the number of repetitions of one set. Exercises are loaded from a CSV
+ * file with one exercise per line:
+ *
+ *    name,label,up_class,down_class,enter_threshold,exit_threshold,target_reps
+ *
+ * followed by an optional column with the keypoints the exercise needs to be
+ * visible, separated by ';' (e.g. left_hip;right_hip;left_knee;right_knee).
+ * Hips, knees and ankles are required when the column is missing, as for the
+ * default 'squats' exercise.
+ *
+ * Empty lines and lines starting with '#' are ignored.
+ *
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../utils/pose_landmark.h"
+
+/**
+ * Exercise definition
+ */
+struct Exercise {
+  std::string name;       // Unique exercise identifier
+  std::string label;      // Text shown on the display
+  std::string up_class;   // Pose class when leaving the repetition
+  std::string down_class; // Pose class counted by the repetition counter
+  int enter_threshold;
+  int exit_threshold;
+  int target_reps;         // Repetitions per set, counter wraps afterwards
+  std::vector<int> joints; // Landmark keypoints that must be visible
+
+  // Class IDs resolved against the pose classifier, -1 when unknown
+  int up_class_id;
+  int down_class_id;
+};
+
+class ExerciseRegistry {
+  static const char *DEFAULT_JOINTS;
+
+  std::vector<Exercise> exercises;
+
+  static std::vector<int> parse_joints(const std::string &joints);
+
+public:
+  // Registry with the default 'squats' exercise
+  ExerciseRegistry();
+  // Registry loaded from a CSV configuration file
+  ExerciseRegistry(const char *exercises_file);
+
+  size_t size() const;
+  const Exercise &at(const size_t &index) const;
+  const std::vector<Exercise> &get_exercises() const;
+};
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Linear or MLP pose classifier
+ *
+ */
+
+#include "mlp_classifier.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+MlpClassifier::MlpClassifier(const char *model_file)
+    : layers{}, class_names{}, activations{}, probabilities{} {
+  load_model(model_file);
+
+  size_t max_size = 0;
+  for (const Layer &layer : layers)
+    max_size = std::max({max_size, layer.stride, pad(layer.outputs)});
+  for (size_t k{0}; k < 2; k++) {
+    activations[k].resize(max_size, 0.0);
+    probabilities[k].resize(class_names.size(), 0.0);
+  }
+}
+
+void MlpClassifier::load_model(const char *model_file) {
+  std::ifstream file_in(model_file);
+  if (!file_in.is_open()) {
+    std::cerr << "Could not open the classifier model " << model_file << "\n";
+    exit(-1);
+  }
+
+  std::string line, word;
+  std::vector<std::string> row;
+  size_t inputs = INPUT_SIZE;
+  Layer *layer = nullptr;
+  size_t neuron = 0;
+  try {
+    while (getline(file_in, line)) {
+      row.clear();
+      std::stringstream str(line);
+      while (getline(str, word, ','))
+        row.push_back(word);
+      if (row.empty())
+        continue;
+
+      if (row.at(0) == "classes") {
+        class_names.assign(row.begin() + 1, row.end());
+      } else if (row.at(0) == "layer") {
+        if (layer != nullptr && neuron < layer->outputs)
+          throw std::invalid_argument("missing weights");
+        if (std::stoul(row.at(1)) != inputs)
+          throw std::invalid_argument("unexpected layer inputs");
+
+        layers.push_back(Layer());
+        layer = &layers.back();
+        layer->inputs = inputs;
+        layer->outputs = std::stoul(row.at(2));
+        layer->stride = pad(inputs);
+        layer->relu = (row.at(3) == "relu");
+        layer->weights.resize(layer->outputs * layer->stride, 0.0);
+        layer->biases.resize(layer->outputs, 0.0);
+        inputs = layer->outputs;
+        neuron = 0;
+      } else {
+        // Weights of one output, followed by its bias
+        if (layer == nullptr || neuron >= layer->outputs ||
+            row.size() != layer->inputs + 1)
+          throw std::invalid_argument("unexpected weights");
+        for (size_t j{0}; j < layer->inputs; j++)
+          layer->weights[neuron * layer->stride + j] = std::stof(row.at(j));
+        layer->biases[neuron] = std::stof(row.at(layer->inputs));
+        neuron++;
+      }
+    }
+    if (layer == nullptr || neuron < layer->outputs)
+      throw std::invalid_argument("missing weights");
+  } catch (const std::exception &e) {
+    std::cerr << "Invalid classifier model " << model_file << ": " << e.what()
+              << "\n";
+    exit(-1);
+  }
+
+  if (class_names.empty() || inputs != class_names.size()) {
+    std::cerr << "Outputs of the classifier model " << model_file
+              << " do not match its classes!\n";
+    exit(-1);
+  }
+  if (class_names.size() > ClassificationResult::MAX_CLASSES) {
+    std::cerr << "Too many pose classes, maximum is "
+              << ClassificationResult::MAX_CLASSES << "!\n";
+    exit(-1);
+  }
+}
+
+ClassificationResult
+MlpClassifier::classify_embedding(const PoseEmbedding &embeddings,
+                                  const PoseEmbedding &flipped_embeddings) {
+  evaluate(embeddings, probabilities[0]);
+  evaluate(flipped_embeddings, probabilities[1]);
+
+  // Orientation with the most confident class
+  const std::vector<float> &best =
+      (*std::max_element(probabilities[0].begin(), probabilities[0].end()) >=
+       *std::max_element(probabilities[1].begin(), probabilities[1].end()))
+          ? probabilities[0]
+          : probabilities[1];
+
+  ClassificationResult classification_result;
+  for (size_t i{0}; i < best.size(); i++)
+    classification_result.put_class_confidence(i, best[i] * MAX_CONFIDENCE);
+  return classification_result;
+}
+
+void MlpClassifier::evaluate(const PoseEmbedding &embedding,
+                             std::vector<float> &scores) {
+  float *input = activations[0].data();
+  float *output = activations[1].data();
+  for (size_t j{0}; j < POSE_EMBEDDING_SIZE; j++) {
+    input[j * 3 + 0] = embedding[j]["x"];
+    input[j * 3 + 1] = embedding[j]["y"];
+    input[j * 3 + 2] = embedding[j]["z"];
+  }
+  std::fill(input + INPUT_SIZE, input + layers.front().stride, 0.0);
+
+  for (const Layer &layer : layers) {
+    forward(layer, input, output);
+    std::swap(input, output);
+  }
+
+  // Softmax of the logits
+  float max_logit = *std::max_element(input, input + scores.size());
+  float sum = 0.0;
+  for (size_t i{0}; i < scores.size(); i++) {
+    scores[i] = std::exp(input[i] - max_logit);
+    sum += scores[i];
+  }
+  for (size_t i{0}; i < scores.size(); i++)
+    scores[i] /= sum;
+}
+
+void MlpClassifier::forward(const Layer &layer, const float *input,
+                            float *output) {
+  for (size_t i{0}; i < layer.outputs; i++) {
+    float value = layer.biases[i] +
+                  dot(&layer.weights[i * layer.stride], input, layer.stride);
+    output[i] = (layer.relu && value < 0.0) ? 0.0 : value;
+  }
+  // Padding of the next layer input
+  std::fill(output + layer.outputs, output + pad(layer.outputs), 0.0);
+}
+
+float MlpClassifier::dot(const float *left, const float *right,
+                         const size_t &size) {
+#if defined(__aarch64__)
+  float32x4_t sum = vdupq_n_f32(0.0);
+  for (size_t j{0}; j < size; j += 4)
+    sum = vfmaq_f32(sum, vld1q_f32(left + j), vld1q_f32(right + j));
+  return vaddvq_f32(sum);
+#else
+  float sum = 0.0;
+  for (size_t j{0}; j < size; j++)
+    sum += left[j] * right[j];
+  return sum;
+#endif
+}
+
+size_t MlpClassifier::pad(const size_t &size) { return (size + 3) / 4 * 4; }
+
+int MlpClassifier::get_class_id(const std::string &class_name) const {
+  for (size_t i{0}; i < class_names.size(); i++) {
+    if (class_names.at(i) == class_name)
+      return i;
+  }
+  return -1;
+}
+
+const std::string &MlpClassifier::get_class_name(const int &class_id) const {
+  return class_names.at(class_id);
+}
+
+size_t MlpClassifier::get_num_classes() const { return class_names.size(); }
+
+const char *MlpClassifier::get_backend_name() const { return "mlp"; }
+
+size_t MlpClassifier::get_num_operations() const {
+  size_t operations = 0;
+  for (const Layer &layer : layers)
+    operations += layer.inputs * layer.outputs;
+  return operations;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Linear or MLP pose classifier
+ *
+ * The model is trained offline from the pose samples by
+ * models/train_classifier.py, and its cost per frame does not depend on the
+ * number of samples. The input is the pose embedding flattened into 69
+ * values (x, y, z of the 23 keypoints), the input normalization is folded
+ * into the first layer. The model file is a CSV file:
+ *
+ *    classes,<class name>,<class name>,...
+ *    layer,<inputs>,<outputs>,<relu|linear>
+ *    <weight>,...,<weight>,<bias>        one line per output of the layer
+ *    layer,...
+ *
+ * The last layer returns one logit per class. Both orientations of the pose
+ * are evaluated, and the one with the most confident class is kept, as k-NN
+ * keeps the closest orientation of every sample.
+ *
+ * Weight rows are padded with zeros to whole NEON vectors, and the dot
+ * products are computed with NEON on aarch64.
+ *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "classification_result.h"
+#include "embedding_classifier.h"
+#include "pose_embedding.h"
+
+class MlpClassifier : public EmbeddingClassifier {
+  static const size_t INPUT_SIZE = POSE_EMBEDDING_SIZE * 3;
+
+  struct Layer {
+    size_t inputs;
+    size_t outputs;
+    size_t stride; // Inputs padded to whole NEON vectors
+    bool relu;
+    std::vector<float> weights; // outputs x stride
+    std::vector<float> biases;
+  };
+
+  std::vector<Layer> layers;
+  std::vector<std::string> class_names; // Class ID is the index in vector
+
+  // Per-frame buffers, sized for the widest layer
+  std::vector<float> activations[2];
+  std::vector<float> probabilities[2]; // Original and flipped orientation
+
+  void load_model(const char *model_file);
+  void evaluate(const PoseEmbedding &embedding, std::vector<float> &scores);
+  static void forward(const Layer &layer, const float *input, float *output);
+  static float dot(const float *left, const float *right, const size_t &size);
+  static size_t pad(const size_t &size);
+
+public:
+  MlpClassifier(const char *model_file);
+
+  ClassificationResult
+  classify_embedding(const PoseEmbedding &embeddings,
+                     const PoseEmbedding &flipped_embeddings) override;
+
+  int get_class_id(const std::string &class_name) const override;
+  const std::string &get_class_name(const int &class_id) const override;
+  size_t get_num_classes() const override;
+  const char *get_backend_name() const override;
+
+  // Multiply-accumulates of one evaluation
+  size_t get_num_operations() const;
+};
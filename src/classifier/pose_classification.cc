@@ -28,11 +28,68 @@
 
 #include "pose_classification.h"
 
-PoseClassifier::PoseClassifier(const char *embeddings_file)
-    : pose_embedding{}, top_n_by_max_distance{30}, top_n_by_mean_distance{10} {
+#include "distance_model.h"
+
+PoseClassifier::PoseClassifier(const char *embeddings_file,
+                               const size_t &num_threads,
+                               const QuantizedIndex::Precision &precision)
+    : pose_embedding{}, top_n_by_max_distance{30}, top_n_by_mean_distance{10},
+      pool{}, scan_embeddings{nullptr}, scan_flipped_embeddings{nullptr},
+      quantized_index{}, index_agreement{1.0}, distance_model{},
+      model_mean_distances{} {
   load_pose_samples(embeddings_file);
+  init(num_threads, precision);
+}
+
+PoseClassifier::PoseClassifier(std::vector<PoseSample> samples,
+                               const std::vector<std::string> &class_names,
+                               const size_t &num_threads,
+                               const QuantizedIndex::Precision &precision)
+    : pose_embedding{}, pose_samples{std::move(samples)},
+      class_names{class_names}, top_n_by_max_distance{30},
+      top_n_by_mean_distance{10}, pool{}, scan_embeddings{nullptr},
+      scan_flipped_embeddings{nullptr}, quantized_index{},
+      index_agreement{1.0}, distance_model{}, model_mean_distances{} {
+  if (class_names.size() > ClassificationResult::MAX_CLASSES) {
+    std::cerr << "Too many pose classes, maximum is "
+              << ClassificationResult::MAX_CLASSES << "!\n";
+    exit(-1);
+  }
+  init(num_threads, precision);
 }
 
+void PoseClassifier::init(const size_t &num_threads,
+                          const QuantizedIndex::Precision &precision) {
+  // Size the per-frame distance buffers
+  max_distances.resize(pose_samples.size());
+  mean_distances.reserve(pose_samples.size());
+
+  if (precision != QuantizedIndex::FLOAT)
+    quantized_index.reset(new QuantizedIndex(precision, pose_samples));
+
+  size_t threads = num_threads;
+  if (threads == 0) {
+    // Waking up the workers only pays off for large pose libraries
+    threads = 1;
+    if (pose_samples.size() >= AUTO_PARALLEL_MIN_SAMPLES)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // Every chunk must be able to hold a full top-N
+  threads = std::min(threads, std::max<size_t>(1, pose_samples.size() /
+                                                      get_num_candidates()));
+
+  if (threads > 1) {
+    pool.reset(new WorkerPool(threads));
+    merged_distances.reserve(threads * get_num_candidates());
+  }
+
+  if (quantized_index)
+    check_quantized_index();
+}
+
+// The distance model is only complete here
+PoseClassifier::~PoseClassifier() {}
+
 void PoseClassifier::load_pose_samples(const char *embeddings_file) {
   std::fstream file_in;
   std::string line, word;
@@ -60,6 +117,7 @@ void PoseClassifier::load_pose_samples(const char *embeddings_file) {
   // Generate pose_samples
   Landmark landmark;
   pose_samples.clear();
+  class_names.clear();
 
   for (size_t i{0}; i < content.size(); i++) {
     for (size_t j{0}; j < 33; j++) {
@@ -76,12 +134,13 @@ void PoseClassifier::load_pose_samples(const char *embeddings_file) {
       landmark[z] = tmp_kp;
     }
 
-    PoseSample sample(content.at(i).at(0), content.at(i).at(1), landmark);
+    PoseSample sample(content.at(i).at(0), content.at(i).at(1),
+                      intern_class_name(content.at(i).at(1)), landmark);
     pose_samples.push_back(sample);
   }
 }
 
-ClassificationResult PoseClassifier::classify_pose(const Landmark &landmark) {
+Landmark PoseClassifier::flip_landmark(const Landmark &landmark) {
   // Create optimized funtion for flipping landmarks
   Landmark flipped_landmarks = landmark;
   for (size_t i{0}; i < 33; i++) {
@@ -89,91 +148,373 @@ ClassificationResult PoseClassifier::classify_pose(const Landmark &landmark) {
                 flipped_landmarks(i)["z"]);
     flipped_landmarks[i] = kp;
   }
+  return flipped_landmarks;
+}
 
+ClassificationResult PoseClassifier::classify_pose(const Landmark &landmark) {
   // Get pose embedding
-  std::vector<Keypoint> embeddings = pose_embedding.get_embedding(landmark);
-  std::vector<Keypoint> flipped_embeddings =
-      pose_embedding.get_embedding(flipped_landmarks);
+  PoseEmbedding embeddings = pose_embedding.get_embedding(landmark);
+  PoseEmbedding flipped_embeddings =
+      pose_embedding.get_embedding(flip_landmark(landmark));
 
+  return classify_embedding(embeddings, flipped_embeddings);
+}
+
+ClassificationResult
+PoseClassifier::classify_embedding(const PoseEmbedding &embeddings,
+                                   const PoseEmbedding &flipped_embeddings) {
   // Filter by max distance
   //
   // That helps to remove outliers - poses that are almost the same as the
   // given one, but has one joint bent into another direction and actually
   // represnt a different pose class.
+  //
+  // Distances are stored with the sample index in buffers sized when the
+  // pose samples are loaded, so no memory is allocated per frame.
+
+  size_t num_max = 0;
+  bool model_distances =
+      distance_model && distance_model->compute(embeddings, flipped_embeddings,
+                                                max_distances,
+                                                model_mean_distances);
+  if (model_distances) {
+    num_max = std::min(top_n_by_max_distance, max_distances.size());
+    std::partial_sort(max_distances.begin(), max_distances.begin() + num_max,
+                      max_distances.end(), compare_distance);
+  } else {
+    if (quantized_index)
+      quantized_index->set_query(embeddings, flipped_embeddings);
+    num_max = pool ? scan_max_distances_parallel(embeddings,
+                                                 flipped_embeddings)
+                   : scan_max_distances(embeddings, flipped_embeddings);
+  }
+
+  // Candidates of the reduced-precision scan are ranked again with the float
+  // distances
+  if (quantized_index && !model_distances) {
+    for (size_t i{0}; i < num_max; i++) {
+      max_distances[i].second = get_max_distance(
+          max_distances[i].first, embeddings, flipped_embeddings);
+    }
+    size_t num_rerank = std::min(top_n_by_max_distance, num_max);
+    std::partial_sort(max_distances.begin(),
+                      max_distances.begin() + num_rerank,
+                      max_distances.begin() + num_max, compare_distance);
+    num_max = num_rerank;
+  }
+
+  // Filter by mean d istance.
+  // After removing outliers we can find the nearest pose by mean distance.
 
-  std::vector<std::pair<PoseSample, float>> maxDistances;
+  mean_distances.clear();
+
+  for (size_t i{0}; i < num_max; i++) {
+    size_t index = max_distances[i].first;
+    float distance =
+        model_distances
+            ? model_mean_distances[index]
+            : get_mean_distance(index, embeddings, flipped_embeddings);
+    mean_distances.push_back(std::pair<size_t, float>(index, distance));
+  }
+
+  // Keep the samples with the smallest mean distance
+  size_t num_mean = std::min(top_n_by_mean_distance, mean_distances.size());
+  std::partial_sort(mean_distances.begin(), mean_distances.begin() + num_mean,
+                    mean_distances.end(), compare_distance);
+
+  ClassificationResult classification_result;
+  for (size_t i{0}; i < num_mean; i++) {
+    classification_result.increment_class_confidence(
+        pose_samples[mean_distances[i].first].get_class_id());
+  }
+
+  return classification_result;
+}
+
+float PoseClassifier::get_max_distance(
+    const size_t &index, const PoseEmbedding &embeddings,
+    const PoseEmbedding &flipped_embeddings) const {
+  float originalMax{0};
+  float flippedMax{0};
 
   Keypoint scale{1.0, 1.0, 0.2};
+  const PoseEmbedding &sample_embedding = pose_samples[index].get_embedding();
+  for (size_t j{0}; j < embeddings.size(); j++) {
+    originalMax =
+        std::max(originalMax,
+                 getMaxAbs((embeddings[j] - sample_embedding[j]) * scale));
+    flippedMax = std::max(
+        flippedMax,
+        getMaxAbs((flipped_embeddings[j] - sample_embedding[j]) * scale));
+  }
+  return std::min(originalMax, flippedMax);
+}
+
+float PoseClassifier::get_mean_distance(
+    const size_t &index, const PoseEmbedding &embeddings,
+    const PoseEmbedding &flipped_embeddings) const {
+  float originalSum{0};
+  float flippedSum{0};
+
+  Keypoint scale{1.0, 1.0, 0.2};
+  const PoseEmbedding &sample_embedding = pose_samples[index].get_embedding();
+  for (size_t j{0}; j < embeddings.size(); j++) {
+    originalSum += getSumAbs((embeddings[j] - sample_embedding[j]) * scale);
+    flippedSum +=
+        getSumAbs((flipped_embeddings[j] - sample_embedding[j]) * scale);
+  }
+  return std::min(originalSum, flippedSum) / (embeddings.size() * 2);
+}
+
+float PoseClassifier::get_scan_distance(
+    const size_t &index, const PoseEmbedding &embeddings,
+    const PoseEmbedding &flipped_embeddings) const {
+  if (quantized_index)
+    return quantized_index->get_max_distance(index);
+  return get_max_distance(index, embeddings, flipped_embeddings);
+}
+
+size_t PoseClassifier::get_num_candidates() const {
+  if (quantized_index)
+    return RERANK_FACTOR * top_n_by_max_distance;
+  return top_n_by_max_distance;
+}
+
+size_t
+PoseClassifier::scan_max_distances(const PoseEmbedding &embeddings,
+                                   const PoseEmbedding &flipped_embeddings) {
   for (size_t i{0}; i < pose_samples.size(); i++) {
-    float originalMax{0};
-    float flippedMax{0};
-
-    for (size_t j{0}; j < embeddings.size(); j++) {
-      originalMax = std::max(
-          originalMax, getMaxAbs((embeddings.at(j) -
-                                  pose_samples.at(i).get_embedding().at(j)) *
-                                 scale));
-      flippedMax = std::max(
-          flippedMax, getMaxAbs((flipped_embeddings.at(j) -
-                                 pose_samples.at(i).get_embedding().at(j)) *
-                                scale));
-    }
-    maxDistances.push_back(std::pair<PoseSample, float>(
-        pose_samples.at(i), std::min(originalMax, flippedMax)));
+    max_distances[i] = std::pair<size_t, float>(
+        i, get_scan_distance(i, embeddings, flipped_embeddings));
   }
 
-  // Sort maxDistances with max ontop
-  std::sort(maxDistances.begin(), maxDistances.end(),
-            [](auto &left, auto &right) { return left.second > right.second; });
+  // Keep the samples with the smallest max distance
+  size_t num_max = std::min(get_num_candidates(), max_distances.size());
+  std::partial_sort(max_distances.begin(), max_distances.begin() + num_max,
+                    max_distances.end(), compare_distance);
+  return num_max;
+}
+
+size_t PoseClassifier::scan_max_distances_parallel(
+    const PoseEmbedding &embeddings, const PoseEmbedding &flipped_embeddings) {
+  scan_embeddings = &embeddings;
+  scan_flipped_embeddings = &flipped_embeddings;
+  pool->run(scan_chunk, this);
 
-  // Remove max distance
-  if (maxDistances.size() > top_n_by_max_distance) {
-    size_t num_to_remove = maxDistances.size() - top_n_by_max_distance;
-    for (size_t i{0}; i < num_to_remove; i++)
-      maxDistances.erase(maxDistances.begin());
+  // Merge the partial top-N of every chunk. Ties are broken by sample index,
+  // so the result is the same as the single-threaded scan.
+  size_t count = pool->size();
+  size_t num_max = get_num_candidates();
+  merged_distances.clear();
+  for (size_t i{0}; i < count; i++) {
+    size_t begin = pose_samples.size() * i / count;
+    merged_distances.insert(merged_distances.end(),
+                            max_distances.begin() + begin,
+                            max_distances.begin() + begin + num_max);
   }
 
-  // Filter by mean d istance.
-  // After removing outliers we can find the nearest pose by mean distance.
+  std::partial_sort(merged_distances.begin(),
+                    merged_distances.begin() + num_max,
+                    merged_distances.end(), compare_distance);
+  std::copy(merged_distances.begin(), merged_distances.begin() + num_max,
+            max_distances.begin());
+  return num_max;
+}
 
-  std::vector<std::pair<PoseSample, float>> meanDistances;
+void PoseClassifier::scan_chunk(void *context, const size_t &index,
+                                const size_t &count) {
+  PoseClassifier *classifier = static_cast<PoseClassifier *>(context);
+  size_t num_samples = classifier->pose_samples.size();
+  size_t begin = num_samples * index / count;
+  size_t end = num_samples * (index + 1) / count;
 
-  for (size_t i{0}; i < maxDistances.size(); i++) {
-    float originalSum{0};
-    float flippedSum{0};
+  for (size_t i{begin}; i < end; i++) {
+    classifier->max_distances[i] = std::pair<size_t, float>(
+        i, classifier->get_scan_distance(
+               i, *classifier->scan_embeddings,
+               *classifier->scan_flipped_embeddings));
+  }
 
-    PoseSample poseSample(maxDistances.at(i).first);
-    for (size_t j{0}; j < embeddings.size(); j++) {
-      originalSum += getSumAbs(
-          (embeddings.at(j) - poseSample.get_embedding().at(j)) * scale);
-      flippedSum += getSumAbs(
-          (flipped_embeddings.at(j) - poseSample.get_embedding().at(j)) *
-          scale);
-    }
-    meanDistances.push_back(std::pair<PoseSample, float>(
-        maxDistances.at(i).first,
-        std::min(originalSum, flippedSum) / (embeddings.size() * 2)));
+  // Partial top-N of the chunk
+  auto first = classifier->max_distances.begin() + begin;
+  std::partial_sort(first, first + classifier->get_num_candidates(),
+                    classifier->max_distances.begin() + end,
+                    compare_distance);
+}
+
+bool PoseClassifier::compare_distance(const std::pair<size_t, float> &left,
+                                      const std::pair<size_t, float> &right) {
+  // Ties are broken by sample index to keep results deterministic
+  if (left.second != right.second)
+    return left.second < right.second;
+  return left.first < right.first;
+}
+
+int PoseClassifier::intern_class_name(const std::string &class_name) {
+  int class_id = get_class_id(class_name);
+  if (class_id >= 0)
+    return class_id;
+
+  if (class_names.size() >= ClassificationResult::MAX_CLASSES) {
+    std::cerr << "Too many pose classes, maximum is "
+              << ClassificationResult::MAX_CLASSES << "!\n";
+    exit(-1);
+  }
+  class_names.push_back(class_name);
+  return class_names.size() - 1;
+}
+
+int PoseClassifier::get_class_id(const std::string &class_name) const {
+  for (size_t i{0}; i < class_names.size(); i++) {
+    if (class_names.at(i) == class_name)
+      return i;
+  }
+  return -1;
+}
+
+const std::string &PoseClassifier::get_class_name(const int &class_id) const {
+  return class_names.at(class_id);
+}
+
+size_t PoseClassifier::get_num_classes() const { return class_names.size(); }
+
+const char *PoseClassifier::get_backend_name() const { return "knn"; }
+
+size_t PoseClassifier::get_num_threads() const {
+  return pool ? pool->size() : 1;
+}
+
+QuantizedIndex::Precision PoseClassifier::get_precision() const {
+  return quantized_index ? quantized_index->get_precision()
+                         : QuantizedIndex::FLOAT;
+}
+
+size_t PoseClassifier::get_index_size_bytes() const {
+  return quantized_index ? quantized_index->get_size_bytes() : 0;
+}
+
+float PoseClassifier::get_index_agreement() const { return index_agreement; }
+
+size_t PoseClassifier::get_num_samples() const { return pose_samples.size(); }
+
+void PoseClassifier::set_distance_model(DistanceModel *model) {
+  distance_model.reset(model);
+  if (distance_model && !distance_model->is_enabled())
+    distance_model.reset();
+  if (distance_model && !check_distance_model()) {
+    std::cerr << "Distance model does not match the pose embeddings, "
+                 "distances are computed on the CPU!\n";
+    distance_model.reset();
   }
+}
 
-  // Sort maxDistances with max ontop
-  std::sort(meanDistances.begin(), meanDistances.end(),
-            [](auto &left, auto &right) { return left.second > right.second; });
+bool PoseClassifier::has_distance_model() const {
+  return distance_model && distance_model->is_enabled();
+}
 
-  // Remove max distance
-  if (meanDistances.size() > top_n_by_mean_distance) {
-    size_t num_to_remove = meanDistances.size() - top_n_by_mean_distance;
-    for (size_t i{0}; i < num_to_remove; i++)
-      meanDistances.erase(meanDistances.begin());
+bool PoseClassifier::check_distance_model() {
+  // Distances of the samples to a zero query, which differ between libraries
+  // of the same size. The tolerance, relative to the largest distance, allows
+  // for INT8 models.
+  const float tolerance = 0.1;
+  PoseEmbedding zero{};
+  if (!distance_model->compute(zero, zero, max_distances,
+                               model_mean_distances))
+    return false;
+
+  std::vector<std::pair<float, float>> expected(pose_samples.size());
+  float largest_max = 0.0;
+  float largest_mean = 0.0;
+  for (size_t i{0}; i < pose_samples.size(); i++) {
+    expected[i].first = get_max_distance(i, zero, zero);
+    expected[i].second = get_mean_distance(i, zero, zero);
+    largest_max = std::max(largest_max, expected[i].first);
+    largest_mean = std::max(largest_mean, expected[i].second);
+  }
+  for (size_t i{0}; i < pose_samples.size(); i++) {
+    if (std::abs(max_distances[i].second - expected[i].first) >
+            tolerance * largest_max ||
+        std::abs(model_mean_distances[i] - expected[i].second) >
+            tolerance * largest_mean)
+      return false;
   }
+  return true;
+}
 
-  ClassificationResult classification_result;
-  for (size_t i{0}; i < meanDistances.size(); i++) {
-    std::string class_name = meanDistances.at(i).first.get_class_name();
-    classification_result.increment_class_confidence(class_name);
+void PoseClassifier::save_embeddings(const char *output_file) const {
+  std::ofstream file_out(output_file);
+  if (!file_out.is_open()) {
+    std::cerr << "Could not open " << output_file << "\n";
+    exit(-1);
   }
 
-  std::string class_output = classification_result.get_max_confidence_class();
-  return classification_result;
+  file_out.precision(9);
+  for (const PoseSample &sample : pose_samples) {
+    const PoseEmbedding &embedding = sample.get_embedding();
+    for (size_t j{0}; j < embedding.size(); j++) {
+      file_out << (j > 0 ? "," : "") << embedding[j]["x"] << ","
+               << embedding[j]["y"] << "," << embedding[j]["z"];
+    }
+    file_out << "\n";
+  }
+}
+
+void PoseClassifier::check_quantized_index() {
+  // Queries are the pose samples and jittered copies of them, classified
+  // with the reduced-precision scan and with the float scan. The number of
+  // queries bounds the float distances computed at load time.
+  const size_t max_distances_checked = 64 * 1024;
+  const float jitter = 0.02;
+  std::mt19937 generator(1337);
+  std::uniform_real_distribution<float> noise(-jitter, jitter);
+
+  size_t max_queries = std::min<size_t>(
+      128, std::max<size_t>(16, max_distances_checked /
+                                    std::max<size_t>(1, pose_samples.size())));
+  size_t step = std::max<size_t>(1, pose_samples.size() / max_queries);
+  size_t num_queries = 0;
+  size_t num_matches = 0;
+  std::unique_ptr<QuantizedIndex> index;
+  for (size_t i{0}; i < pose_samples.size(); i += step) {
+    for (size_t k{0}; k < 2; k++) {
+      PoseEmbedding embeddings = pose_samples[i].get_embedding();
+      PoseEmbedding flipped_embeddings;
+      for (size_t j{0}; j < embeddings.size(); j++) {
+        if (k == 1) {
+          embeddings[j] += Keypoint(noise(generator), noise(generator),
+                                    noise(generator));
+        }
+        // Flipping the landmark flips the x axis of the embedding
+        flipped_embeddings[j] = embeddings[j] * Keypoint(-1.0, 1.0, 1.0);
+      }
+
+      ClassificationResult result =
+          classify_embedding(embeddings, flipped_embeddings);
+      index = std::move(quantized_index);
+      ClassificationResult reference =
+          classify_embedding(embeddings, flipped_embeddings);
+      quantized_index = std::move(index);
+
+      bool match = true;
+      for (size_t c{0}; c < class_names.size(); c++) {
+        if (result.get_class_confidence(c) !=
+            reference.get_class_confidence(c))
+          match = false;
+      }
+      num_matches += match;
+      num_queries++;
+    }
+  }
+
+  index_agreement = (num_queries > 0) ? (float)num_matches / num_queries : 1.0;
+  if (index_agreement < MIN_INDEX_AGREEMENT) {
+    std::cerr << "Pose classifier "
+              << QuantizedIndex::get_precision_name(
+                     quantized_index->get_precision())
+              << " results match float on " << index_agreement * 100.0
+              << "% of the queries, using float!\n";
+    quantized_index.reset();
+  }
 }
 
 float PoseClassifier::getMaxAbs(const Keypoint &point) {
@@ -28,28 +28,129 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "classification_result.h"
 #include "classification_smoothing.h"
+#include "embedding_classifier.h"
 #include "pose_embedding.h"
 #include "pose_sample.h"
+#include "quantized_index.h"
+#include "../utils/worker_pool.h"
 
-class PoseClassifier {
+// Defined in distance_model.h, which depends on GStreamer
+class DistanceModel;
+
+class PoseClassifier : public EmbeddingClassifier {
   FullBodyPoseEmbedder pose_embedding;
   std::vector<PoseSample> pose_samples;
+  std::vector<std::string> class_names; // Class ID is the index in vector
   const size_t top_n_by_max_distance;
   const size_t top_n_by_mean_distance;
 
+  // Per-frame buffers of (sample index, distance)
+  std::vector<std::pair<size_t, float>> max_distances;
+  std::vector<std::pair<size_t, float>> mean_distances;
+
+  // Parallel max distance scan. Each slot of the pool scans a contiguous
+  // chunk of the samples and keeps its own top-N at the front of the chunk,
+  // which are then merged into the global top-N.
+  std::unique_ptr<WorkerPool> pool;
+  std::vector<std::pair<size_t, float>> merged_distances;
+  const PoseEmbedding *scan_embeddings;
+  const PoseEmbedding *scan_flipped_embeddings;
+
+  // Optional reduced-precision index for the max distance scan. The scan
+  // keeps more candidates, ranked again with the float distances.
+  std::unique_ptr<QuantizedIndex> quantized_index;
+  float index_agreement;
+
+  // Optional model computing the distances to all the samples, on the NPU
+  // when delegated. The CPU scan is used when it gives no result.
+  std::unique_ptr<DistanceModel> distance_model;
+  std::vector<float> model_mean_distances; // Indexed by sample
+
   void load_pose_samples(const char *embeddings_file);
-  float getMaxAbs(const Keypoint &point);
-  float getSumAbs(const Keypoint &point);
+  void init(const size_t &num_threads,
+            const QuantizedIndex::Precision &precision);
+  int intern_class_name(const std::string &class_name);
+  static float getMaxAbs(const Keypoint &point);
+  static float getSumAbs(const Keypoint &point);
+  float get_max_distance(const size_t &index, const PoseEmbedding &embeddings,
+                         const PoseEmbedding &flipped_embeddings) const;
+  float get_mean_distance(const size_t &index, const PoseEmbedding &embeddings,
+                          const PoseEmbedding &flipped_embeddings) const;
+  float get_scan_distance(const size_t &index, const PoseEmbedding &embeddings,
+                          const PoseEmbedding &flipped_embeddings) const;
+  size_t get_num_candidates() const;
+  void check_quantized_index();
+  bool check_distance_model();
+  size_t scan_max_distances(const PoseEmbedding &embeddings,
+                            const PoseEmbedding &flipped_embeddings);
+  size_t scan_max_distances_parallel(const PoseEmbedding &embeddings,
+                                     const PoseEmbedding &flipped_embeddings);
+  static void scan_chunk(void *context, const size_t &index,
+                         const size_t &count);
+  static bool compare_distance(const std::pair<size_t, float> &left,
+                               const std::pair<size_t, float> &right);
 
 public:
-  PoseClassifier(const char *embeddings_file);
+  // Sample count above which the auto mode scans in parallel
+  static const size_t AUTO_PARALLEL_MIN_SAMPLES = 2048;
+  // Candidates of the reduced-precision scan, per result of the float scan
+  static const size_t RERANK_FACTOR = 2;
+  // Results of the reduced-precision index that must match the float ones,
+  // checked at load time, the float scan is used otherwise
+  static constexpr float MIN_INDEX_AGREEMENT = 0.99;
+
+  // num_threads: 1 scans on the calling thread, 0 selects the auto mode
+  PoseClassifier(
+      const char *embeddings_file, const size_t &num_threads = 1,
+      const QuantizedIndex::Precision &precision = QuantizedIndex::FLOAT);
+  // Pose samples built in memory, their class IDs index class_names
+  PoseClassifier(
+      std::vector<PoseSample> samples,
+      const std::vector<std::string> &class_names,
+      const size_t &num_threads = 1,
+      const QuantizedIndex::Precision &precision = QuantizedIndex::FLOAT);
+  ~PoseClassifier();
 
   ClassificationResult classify_pose(const Landmark &landmark);
+  ClassificationResult
+  classify_embedding(const PoseEmbedding &embeddings,
+                     const PoseEmbedding &flipped_embeddings) override;
+
+  static Landmark flip_landmark(const Landmark &landmark);
+
+  // Class IDs are assigned once when the pose samples are loaded
+  int get_class_id(const std::string &class_name) const override;
+  const std::string &get_class_name(const int &class_id) const override;
+  size_t get_num_classes() const override;
+  const char *get_backend_name() const override;
+  // Number of threads used by the max distance scan
+  size_t get_num_threads() const;
+  // Precision of the max distance scan, with the size of its index and the
+  // ratio of results matching the float scan
+  QuantizedIndex::Precision get_precision() const;
+  size_t get_index_size_bytes() const;
+  float get_index_agreement() const;
+
+  size_t get_num_samples() const;
+  // Takes ownership of the model, which must be generated from the
+  // embeddings of the loaded pose samples. The model is not used when its
+  // distances differ from the CPU ones.
+  void set_distance_model(DistanceModel *model);
+  bool has_distance_model() const;
+  // Embeddings of the pose samples, one sample per line with the x, y, z
+  // values of its 23 keypoints, for models/generate_distance_model.py
+  void save_embeddings(const char *output_file) const;
 };
@@ -43,8 +43,7 @@ Result:
 Vector with pose embedding of shape (M, 3) where `M` is the number of
 pairwise distances.
 */
-std::vector<Keypoint>
-FullBodyPoseEmbedder::get_embedding(const Landmark &landmark) {
+PoseEmbedding FullBodyPoseEmbedder::get_embedding(const Landmark &landmark) {
   // Copy landmarks to new array
   this->landmark = landmark;
 
@@ -85,7 +84,7 @@ float FullBodyPoseEmbedder::get_pose_size() {
   return max_distance;
 }
 
-std::vector<Keypoint> FullBodyPoseEmbedder::get_pose_distance_embedding() {
+PoseEmbedding FullBodyPoseEmbedder::get_pose_distance_embedding() {
   // Converts pose landmarks into 3D embedding.
   //
   // We use several pairwise 3D distances to form pose embedding. All distances
@@ -98,7 +97,8 @@ std::vector<Keypoint> FullBodyPoseEmbedder::get_pose_distance_embedding() {
   // Result:
   // Numpy array with pose embedding of shape (M, 3) where `M` is the number of
   // pairwise distances.
-  std::vector<Keypoint> embedding;
+  PoseEmbedding embedding;
+  size_t n{0};
 
   // **ONE JOINT
 
@@ -107,77 +107,72 @@ std::vector<Keypoint> FullBodyPoseEmbedder::get_pose_distance_embedding() {
   Keypoint average_hip((landmark["left_hip"] + landmark["right_hip"]) * 0.5);
   Keypoint average_shoulder(
       (landmark["left_shoulder"] + landmark["right_shoulder"]) * 0.5);
-  embedding.push_back(average_shoulder - average_hip);
+  embedding[n++] = average_shoulder - average_hip;
 
   // Get distance from left_shoulder to left_elbow
-  embedding.push_back((landmark["left_shoulder"] + landmark["left_elbow"]) *
-                      0.5);
+  embedding[n++] = (landmark["left_shoulder"] + landmark["left_elbow"]) * 0.5;
   // Get distance from right_shoulder to right_elbow
-  embedding.push_back((landmark["right_shoulder"] + landmark["right_elbow"]) *
-                      0.5);
+  embedding[n++] = (landmark["right_shoulder"] + landmark["right_elbow"]) * 0.5;
 
   // Get distance from left_elbow to left_wrist
-  embedding.push_back((landmark["left_elbow"] + landmark["left_wrist"]) * 0.5);
+  embedding[n++] = (landmark["left_elbow"] + landmark["left_wrist"]) * 0.5;
   // Get distance from right_elbow to right_wrist
-  embedding.push_back((landmark["right_elbow"] + landmark["right_wrist"]) *
-                      0.5);
+  embedding[n++] = (landmark["right_elbow"] + landmark["right_wrist"]) * 0.5;
 
   // Get distance from left_hip to left_knee
-  embedding.push_back((landmark["left_hip"] + landmark["left_knee"]) * 0.5);
+  embedding[n++] = (landmark["left_hip"] + landmark["left_knee"]) * 0.5;
   // Get distance from right_hip to right_knee
-  embedding.push_back((landmark["right_hip"] + landmark["right_knee"]) * 0.5);
+  embedding[n++] = (landmark["right_hip"] + landmark["right_knee"]) * 0.5;
 
   // Get distance from left_knee to left_ankle
-  embedding.push_back((landmark["left_knee"] + landmark["left_ankle"]) * 0.5);
+  embedding[n++] = (landmark["left_knee"] + landmark["left_ankle"]) * 0.5;
   // Get distance from right_knee to right_ankle
-  embedding.push_back((landmark["right_knee"] + landmark["right_ankle"]) * 0.5);
+  embedding[n++] = (landmark["right_knee"] + landmark["right_ankle"]) * 0.5;
 
   // **TWO JOINTS
 
   // Get distance from left_shoulders to left_wrist
-  embedding.push_back((landmark["left_shoulders"] + landmark["left_wrist"]) *
-                      0.5);
+  embedding[n++] = (landmark["left_shoulders"] + landmark["left_wrist"]) * 0.5;
   // Get distance from right_shoulders to right_wrist
-  embedding.push_back((landmark["right_shoulders"] + landmark["right_wrist"]) *
-                      0.5);
+  embedding[n++] =
+      (landmark["right_shoulders"] + landmark["right_wrist"]) * 0.5;
 
   // Get distance from left_hip to left_ankle
-  embedding.push_back((landmark["left_hip"] + landmark["left_ankle"]) * 0.5);
+  embedding[n++] = (landmark["left_hip"] + landmark["left_ankle"]) * 0.5;
   // Get distance from right_hip to right_ankle
-  embedding.push_back((landmark["right_hip"] + landmark["right_ankle"]) * 0.5);
+  embedding[n++] = (landmark["right_hip"] + landmark["right_ankle"]) * 0.5;
 
   // **FOUR JOINTS
 
   // Get distance from left_hip to left_wrist
-  embedding.push_back((landmark["left_hip"] + landmark["left_wrist"]) * 0.5);
+  embedding[n++] = (landmark["left_hip"] + landmark["left_wrist"]) * 0.5;
   // Get distance from right_hip to right_wrist
-  embedding.push_back((landmark["right_hip"] + landmark["right_wrist"]) * 0.5);
+  embedding[n++] = (landmark["right_hip"] + landmark["right_wrist"]) * 0.5;
 
   // **FIVE JOINTS
 
   // Get distance from left_shoulders to left_ankle
-  embedding.push_back((landmark["left_shoulders"] + landmark["left_ankle"]) *
-                      0.5);
+  embedding[n++] = (landmark["left_shoulders"] + landmark["left_ankle"]) * 0.5;
   // Get distance from right_shoulders to right_ankle
-  embedding.push_back((landmark["right_shoulders"] + landmark["right_ankle"]) *
-                      0.5);
+  embedding[n++] =
+      (landmark["right_shoulders"] + landmark["right_ankle"]) * 0.5;
 
   // Get distance from left_hip to left_wrist
-  embedding.push_back((landmark["left_hip"] + landmark["left_wrist"]) * 0.5);
+  embedding[n++] = (landmark["left_hip"] + landmark["left_wrist"]) * 0.5;
   // Get distance from right_hip to right_wrist
-  embedding.push_back((landmark["right_hip"] + landmark["right_wrist"]) * 0.5);
+  embedding[n++] = (landmark["right_hip"] + landmark["right_wrist"]) * 0.5;
 
   // ** CROSS BODY
 
   // Get distance from left_elbow to right_elbow
-  embedding.push_back((landmark["left_elbow"] + landmark["right_elbow"]) * 0.5);
+  embedding[n++] = (landmark["left_elbow"] + landmark["right_elbow"]) * 0.5;
   // Get distance from left_knee to right_knee
-  embedding.push_back((landmark["left_knee"] + landmark["right_knee"]) * 0.5);
+  embedding[n++] = (landmark["left_knee"] + landmark["right_knee"]) * 0.5;
 
   // Get distance from left_wrist to right_wrist
-  embedding.push_back((landmark["left_wrist"] + landmark["right_wrist"]) * 0.5);
+  embedding[n++] = (landmark["left_wrist"] + landmark["right_wrist"]) * 0.5;
   // Get distance from left_ankle to right_ankle
-  embedding.push_back((landmark["left_ankle"] + landmark["right_ankle"]) * 0.5);
+  embedding[n++] = (landmark["left_ankle"] + landmark["right_ankle"]) * 0.5;
 
   return embedding;
 }
@@ -33,9 +33,14 @@
 #include <vector>
 // #include <cmath>
 #include <algorithm>
+#include <array>
 
 #include "../utils/pose_landmark.h"
 
+// Number of pairwise distances in the pose embedding
+const size_t POSE_EMBEDDING_SIZE = 23;
+typedef std::array<Keypoint, POSE_EMBEDDING_SIZE> PoseEmbedding;
+
 class FullBodyPoseEmbedder {
   const size_t number_raw_points;
   const size_t number_keypoints;
@@ -47,9 +52,9 @@ class FullBodyPoseEmbedder {
 
   Keypoint get_pose_center();
   float get_pose_size();
-  std::vector<Keypoint> get_pose_distance_embedding();
+  PoseEmbedding get_pose_distance_embedding();
 
 public:
   FullBodyPoseEmbedder(float torso_size_multiplier = 2.5);
-  std::vector<Keypoint> get_embedding(const Landmark &landmark);
+  PoseEmbedding get_embedding(const Landmark &landmark);
 };
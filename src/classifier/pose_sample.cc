@@ -31,19 +31,22 @@
 PoseSample::PoseSample() : pose_embedding() {
   this->name = "";
   this->class_name = "";
+  this->class_id = -1;
 }
 
 PoseSample::PoseSample(std::string name, std::string class_name,
-                       const Landmark &landmark)
+                       const int &class_id, const Landmark &landmark)
     : PoseSample() {
   this->name = name;
   this->class_name = class_name;
+  this->class_id = class_id;
   this->embedding = pose_embedding.get_embedding(landmark);
 }
 
 PoseSample::PoseSample(const PoseSample &pose_sample) : PoseSample() {
   this->name = pose_sample.name;
   this->class_name = pose_sample.class_name;
+  this->class_id = pose_sample.class_id;
   this->embedding = pose_sample.embedding;
 }
 
@@ -54,6 +57,7 @@ PoseSample &PoseSample::operator=(const PoseSample &pose) {
 
   this->name = pose.name;
   this->class_name = pose.class_name;
+  this->class_id = pose.class_id;
   this->embedding = pose.embedding;
 
   return *this;
@@ -61,4 +65,7 @@ PoseSample &PoseSample::operator=(const PoseSample &pose) {
 
 std::string PoseSample::get_name() { return this->name; }
 std::string PoseSample::get_class_name() { return this->class_name; }
-std::vector<Keypoint> PoseSample::get_embedding() { return this->embedding; }
+int PoseSample::get_class_id() const { return this->class_id; }
+const PoseEmbedding &PoseSample::get_embedding() const {
+  return this->embedding;
+}
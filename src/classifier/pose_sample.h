@@ -39,11 +39,12 @@ class PoseSample {
 
   std::string name;
   std::string class_name;
-  std::vector<Keypoint> embedding;
+  int class_id;
+  PoseEmbedding embedding;
 
 public:
   PoseSample();
-  PoseSample(std::string name, std::string class_name,
+  PoseSample(std::string name, std::string class_name, const int &class_id,
              const Landmark &landmark);
   PoseSample(const PoseSample &pose_sample);
 
@@ -51,5 +52,6 @@ public:
 
   std::string get_name();
   std::string get_class_name();
-  std::vector<Keypoint> get_embedding();
+  int get_class_id() const;
+  const PoseEmbedding &get_embedding() const;
 };
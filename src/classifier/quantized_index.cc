@@ -0,0 +1,280 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Reduced-precision index of the pose sample embeddings
+ *
+ */
+
+#include "quantized_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+QuantizedIndex::QuantizedIndex(const Precision &precision,
+                               const std::vector<PoseSample> &pose_samples)
+    : precision{precision}, num_samples{pose_samples.size()}, rows_int8{},
+      rows_fp16{}, scales{}, weights{}, distance_scale{0.0}, query_int8{},
+      query_fp16{}, query_float{} {
+  std::vector<float> values(num_samples * ROW_SIZE, 0.0);
+  for (size_t i{0}; i < num_samples; i++)
+    flatten(pose_samples.at(i).get_embedding(), &values[i * ROW_SIZE]);
+
+  if (precision == FP16) {
+    rows_fp16.resize(num_samples * ROW_SIZE);
+    for (size_t i{0}; i < values.size(); i++)
+      rows_fp16[i] = float_to_half(values[i]);
+    return;
+  }
+
+  // Symmetric quantization of each dimension over its range in the library
+  float max_scale = 0.0;
+  for (size_t j{0}; j < NUM_VALUES; j++) {
+    float max_abs = 0.0;
+    for (size_t i{0}; i < num_samples; i++)
+      max_abs = std::max(max_abs, std::abs(values[i * ROW_SIZE + j]));
+    scales[j] = std::max(max_abs, 1e-6f) / 127.0f;
+    max_scale = std::max(max_scale, scales[j]);
+  }
+
+  // Absolute differences are weighted by the relative scale of their
+  // dimension, so the weighted maximum is comparable across dimensions
+  for (size_t j{0}; j < NUM_VALUES; j++) {
+    weights[j] = (uint8_t)std::max(
+        1.0f, std::round(255.0f * scales[j] / max_scale));
+  }
+  distance_scale = max_scale / 255.0f;
+
+  rows_int8.resize(num_samples * ROW_SIZE);
+  for (size_t i{0}; i < num_samples; i++)
+    quantize(&values[i * ROW_SIZE], &rows_int8[i * ROW_SIZE]);
+}
+
+void QuantizedIndex::flatten(const PoseEmbedding &embedding, float *values) {
+  // Same weights as the float distances of the classifier
+  for (size_t j{0}; j < POSE_EMBEDDING_SIZE; j++) {
+    values[j * 3 + 0] = embedding[j]["x"];
+    values[j * 3 + 1] = embedding[j]["y"];
+    values[j * 3 + 2] = embedding[j]["z"] * 0.2f;
+  }
+  for (size_t j{NUM_VALUES}; j < ROW_SIZE; j++)
+    values[j] = 0.0;
+}
+
+void QuantizedIndex::quantize(const float *values, int8_t *row) const {
+  for (size_t j{0}; j < NUM_VALUES; j++) {
+    float value = std::round(values[j] / scales[j]);
+    row[j] = (int8_t)std::min(127.0f, std::max(-127.0f, value));
+  }
+  for (size_t j{NUM_VALUES}; j < ROW_SIZE; j++)
+    row[j] = 0;
+}
+
+void QuantizedIndex::set_query(const PoseEmbedding &embeddings,
+                               const PoseEmbedding &flipped_embeddings) {
+  flatten(embeddings, query_float[0]);
+  flatten(flipped_embeddings, query_float[1]);
+
+  for (size_t k{0}; k < 2; k++) {
+    if (precision == INT8) {
+      quantize(query_float[k], query_int8[k]);
+    } else if (precision == FP16) {
+      for (size_t j{0}; j < ROW_SIZE; j++)
+        query_fp16[k][j] = float_to_half(query_float[k][j]);
+    }
+  }
+}
+
+float QuantizedIndex::get_max_distance(const size_t &index) const {
+  if (precision == INT8)
+    return get_max_distance_int8(&rows_int8[index * ROW_SIZE]);
+  return get_max_distance_fp16(&rows_fp16[index * ROW_SIZE]);
+}
+
+float QuantizedIndex::get_max_distance_int8(const int8_t *row) const {
+#if defined(__aarch64__)
+  // |query - sample| fits in 8 bits unsigned, weighted in 16 bits
+  uint16x8_t original_max = vdupq_n_u16(0);
+  uint16x8_t flipped_max = vdupq_n_u16(0);
+  for (size_t j{0}; j < 64; j += 16) {
+    int8x16_t sample = vld1q_s8(row + j);
+    uint8x16_t weight = vld1q_u8(weights + j);
+    uint8x16_t original =
+        vreinterpretq_u8_s8(vabdq_s8(vld1q_s8(query_int8[0] + j), sample));
+    uint8x16_t flipped =
+        vreinterpretq_u8_s8(vabdq_s8(vld1q_s8(query_int8[1] + j), sample));
+    original_max = vmaxq_u16(
+        original_max, vmull_u8(vget_low_u8(original), vget_low_u8(weight)));
+    original_max = vmaxq_u16(original_max, vmull_high_u8(original, weight));
+    flipped_max = vmaxq_u16(
+        flipped_max, vmull_u8(vget_low_u8(flipped), vget_low_u8(weight)));
+    flipped_max = vmaxq_u16(flipped_max, vmull_high_u8(flipped, weight));
+  }
+
+  // Last 8 values of the row
+  int8x8_t sample = vld1_s8(row + 64);
+  uint8x8_t weight = vld1_u8(weights + 64);
+  original_max = vmaxq_u16(
+      original_max,
+      vmull_u8(vreinterpret_u8_s8(vabd_s8(vld1_s8(query_int8[0] + 64), sample)),
+               weight));
+  flipped_max = vmaxq_u16(
+      flipped_max,
+      vmull_u8(vreinterpret_u8_s8(vabd_s8(vld1_s8(query_int8[1] + 64), sample)),
+               weight));
+
+  return std::min(vmaxvq_u16(original_max), vmaxvq_u16(flipped_max)) *
+         distance_scale;
+#else
+  int original_max = 0;
+  int flipped_max = 0;
+  for (size_t j{0}; j < ROW_SIZE; j++) {
+    original_max = std::max(
+        original_max, std::abs(query_int8[0][j] - row[j]) * weights[j]);
+    flipped_max = std::max(flipped_max,
+                           std::abs(query_int8[1][j] - row[j]) * weights[j]);
+  }
+  return std::min(original_max, flipped_max) * distance_scale;
+#endif
+}
+
+float QuantizedIndex::get_max_distance_fp16(const uint16_t *row) const {
+#if defined(__aarch64__) && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+  float16x8_t original_max = vdupq_n_f16(0.0);
+  float16x8_t flipped_max = vdupq_n_f16(0.0);
+  for (size_t j{0}; j < ROW_SIZE; j += 8) {
+    float16x8_t sample = vreinterpretq_f16_u16(vld1q_u16(row + j));
+    original_max = vmaxq_f16(
+        original_max,
+        vabdq_f16(vreinterpretq_f16_u16(vld1q_u16(query_fp16[0] + j)), sample));
+    flipped_max = vmaxq_f16(
+        flipped_max,
+        vabdq_f16(vreinterpretq_f16_u16(vld1q_u16(query_fp16[1] + j)), sample));
+  }
+  return std::min((float)vmaxvq_f16(original_max),
+                  (float)vmaxvq_f16(flipped_max));
+#elif defined(__aarch64__)
+  // Half precision storage, float arithmetic
+  float32x4_t original_max = vdupq_n_f32(0.0);
+  float32x4_t flipped_max = vdupq_n_f32(0.0);
+  for (size_t j{0}; j < ROW_SIZE; j += 4) {
+    float32x4_t sample = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(row + j)));
+    original_max = vmaxq_f32(
+        original_max, vabdq_f32(vld1q_f32(query_float[0] + j), sample));
+    flipped_max = vmaxq_f32(flipped_max,
+                            vabdq_f32(vld1q_f32(query_float[1] + j), sample));
+  }
+  return std::min(vmaxvq_f32(original_max), vmaxvq_f32(flipped_max));
+#else
+  float original_max = 0.0;
+  float flipped_max = 0.0;
+  for (size_t j{0}; j < ROW_SIZE; j++) {
+    float sample = half_to_float(row[j]);
+    original_max =
+        std::max(original_max, std::abs(query_float[0][j] - sample));
+    flipped_max = std::max(flipped_max, std::abs(query_float[1][j] - sample));
+  }
+  return std::min(original_max, flipped_max);
+#endif
+}
+
+QuantizedIndex::Precision QuantizedIndex::get_precision() const {
+  return precision;
+}
+
+size_t QuantizedIndex::get_size_bytes() const {
+  return rows_int8.size() * sizeof(int8_t) +
+         rows_fp16.size() * sizeof(uint16_t);
+}
+
+bool QuantizedIndex::parse_precision(const std::string &name,
+                                     Precision &precision) {
+  if (name == "float")
+    precision = FLOAT;
+  else if (name == "fp16")
+    precision = FP16;
+  else if (name == "int8")
+    precision = INT8;
+  else
+    return false;
+  return true;
+}
+
+const char *QuantizedIndex::get_precision_name(const Precision &precision) {
+  switch (precision) {
+  case FP16:
+    return "fp16";
+  case INT8:
+    return "int8";
+  default:
+    return "float";
+  }
+}
+
+uint16_t QuantizedIndex::float_to_half(const float &value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t mantissa = bits & 0x7fffff;
+  int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+
+  // Infinity and NaN
+  if (((bits >> 23) & 0xff) == 0xff)
+    return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+  if (exponent >= 31)
+    return sign | 0x7c00;
+
+  // Subnormal half, rounded to nearest even
+  if (exponent <= 0) {
+    if (exponent < -10)
+      return sign;
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exponent;
+    uint32_t half = mantissa >> shift;
+    uint32_t rest = mantissa & ((1u << shift) - 1);
+    uint32_t midpoint = 1u << (shift - 1);
+    if (rest > midpoint || (rest == midpoint && (half & 1)))
+      half++;
+    return sign | half;
+  }
+
+  // Normal half, a carry of the rounding goes into the exponent
+  uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+  uint32_t rest = mantissa & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    half++;
+  return sign | half;
+}
+
+float QuantizedIndex::half_to_float(const uint16_t &value) {
+  uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+  int exponent = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+
+  uint32_t bits;
+  if (exponent == 0 && mantissa == 0) {
+    bits = sign;
+  } else if (exponent == 0) {
+    // Subnormal half, normalized in float
+    exponent = 1;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    mantissa &= 0x3ff;
+    bits = sign | ((uint32_t)(exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (exponent == 31) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    bits = sign | ((uint32_t)(exponent + 127 - 15) << 23) | (mantissa << 13);
+  }
+
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
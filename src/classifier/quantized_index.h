@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Reduced-precision index of the pose sample embeddings
+ *
+ * The 23 keypoints of every embedding are flattened into one row of 69
+ * values, with the z weight of the classifier applied, and padded to 72
+ * values so a row is made of whole NEON vectors. Rows are stored
+ * contiguously:
+ *
+ *  - INT8: each dimension is quantized with its own scale, so dimensions
+ *    with a small range keep their resolution. The max-abs distance is
+ *    computed on the integer absolute differences weighted by the relative
+ *    scale of the dimension (8-bit fixed point), 72 bytes per sample.
+ *  - FP16: half precision values, 144 bytes per sample. Differences are
+ *    computed in fp16 when built with ENABLE_FP16_ARITHMETIC for cores with
+ *    the fp16 vector arithmetic (e.g. Cortex-A55), and in float after
+ *    conversion otherwise.
+ *
+ * Distances are approximate, the classifier only uses them to select the
+ * candidates which are then ranked again with the float embeddings.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pose_embedding.h"
+#include "pose_sample.h"
+
+class QuantizedIndex {
+public:
+  enum Precision { FLOAT, FP16, INT8 };
+
+  // Values of an embedding, padded to whole NEON vectors
+  static const size_t NUM_VALUES = POSE_EMBEDDING_SIZE * 3;
+  static const size_t ROW_SIZE = 72;
+
+private:
+  Precision precision;
+  size_t num_samples;
+
+  std::vector<int8_t> rows_int8;
+  std::vector<uint16_t> rows_fp16;
+
+  // Per-dimension quantization of the INT8 rows
+  alignas(16) float scales[ROW_SIZE];
+  alignas(16) uint8_t weights[ROW_SIZE]; // Scale relative to the largest one
+  float distance_scale;                  // Weighted distance to float
+
+  // Query of the frame, original and flipped embeddings
+  alignas(16) int8_t query_int8[2][ROW_SIZE];
+  alignas(16) uint16_t query_fp16[2][ROW_SIZE];
+  alignas(16) float query_float[2][ROW_SIZE];
+
+  static void flatten(const PoseEmbedding &embedding, float *values);
+  void quantize(const float *values, int8_t *row) const;
+  float get_max_distance_int8(const int8_t *row) const;
+  float get_max_distance_fp16(const uint16_t *row) const;
+
+public:
+  QuantizedIndex(const Precision &precision,
+                 const std::vector<PoseSample> &pose_samples);
+
+  // Called once per frame, before the distances are computed
+  void set_query(const PoseEmbedding &embeddings,
+                 const PoseEmbedding &flipped_embeddings);
+  // Approximate max-abs distance of a sample to the query, the smallest of
+  // both orientations
+  float get_max_distance(const size_t &index) const;
+
+  Precision get_precision() const;
+  // Size of the rows of all samples
+  size_t get_size_bytes() const;
+
+  static bool parse_precision(const std::string &name, Precision &precision);
+  static const char *get_precision_name(const Precision &precision);
+
+  // IEEE 754 half precision conversions
+  static uint16_t float_to_half(const float &value);
+  static float half_to_float(const uint16_t &value);
+};
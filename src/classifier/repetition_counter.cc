@@ -28,24 +28,24 @@
 
 #include "repetition_counter.h"
 
-RepetitionCounter::RepetitionCounter(const std::string &class_name,
+RepetitionCounter::RepetitionCounter(const int &class_id,
                                      const int &enter_threshold,
-                                     const int &exit_threshold) {
-  this->class_name = class_name;
+                                     const int &exit_threshold,
+                                     const int &target_reps) {
+  this->class_id = class_id;
   this->enter_threshold = enter_threshold;
   this->exit_threshold = exit_threshold;
+  this->target_reps = target_reps;
   pose_entered = false;
   n_repeats = 0;
 }
 
-int RepetitionCounter::count(ClassificationResult &result) {
-  n_repeats = n_repeats % 12;
+int RepetitionCounter::count(const ClassificationResult &result) {
+  if (target_reps > 0)
+    n_repeats = n_repeats % target_reps;
 
   // Get pose confidence
-  float pose_confidence = 0.0;
-  if (result.has_key(class_name)) {
-    pose_confidence = result.get_class_confidence(class_name);
-  }
+  float pose_confidence = result.get_class_confidence(class_id);
 
   // On the very first frame or if we were out of the pose, just check if we
   // entered it on this frame and update the state.
@@ -63,3 +63,5 @@ int RepetitionCounter::count(ClassificationResult &result) {
 
   return n_repeats;
 }
+
+int RepetitionCounter::get_repetitions() const { return n_repeats; }
@@ -28,20 +28,20 @@
 
 #pragma once
 
-#include <string>
-
 #include "classification_result.h"
 
 class RepetitionCounter {
-  std::string class_name;
+  int class_id;
   int enter_threshold;
   int exit_threshold;
+  int target_reps;
   bool pose_entered;
   int n_repeats;
 
 public:
-  RepetitionCounter(const std::string &class_name,
-                    const int &enter_threshold = 8,
-                    const int &exit_threshold = 2);
-  int count(ClassificationResult &result);
+  RepetitionCounter(const int &class_id, const int &enter_threshold = 8,
+                    const int &exit_threshold = 2,
+                    const int &target_reps = 12);
+  int count(const ClassificationResult &result);
+  int get_repetitions() const;
 };
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * NNStreamer decoder subplugin of the pose detection model
+ *
+ * tensor_decoder mode=imx_pose_detection decodes the output tensors of the
+ * pose detection model with PoseDetectionInterpreter, and returns the region
+ * of the pose closest to the center of the frame as a float32 tensor [1, 5]:
+ *
+ *    present, xmin, ymin, xmax, ymax
+ *
+ * The region is in frame pixels, as computed by get_pose_roi() in the
+ * application, and present is 0 when no pose is detected. Options:
+ *
+ *  - option1: size of the square model input (224 by default)
+ *  - option2: frame size WIDTH:HEIGHT (640:480 by default)
+ *  - option3: size of the frame fed to the model, padded or stretched,
+ *    WIDTH:HEIGHT (square of the largest frame side by default)
+ *  - option4: anchors file (anchors of the 224x224 model by default)
+ *
+ * Caps negotiation fails when the tensors are not the outputs of a pose
+ * detection model or do not match the anchors.
+ *
+ */
+
+#include <glib.h>
+#include <gst/gst.h>
+#include <nnstreamer/nnstreamer_plugin_api.h>
+#include <nnstreamer/nnstreamer_plugin_api_decoder.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../mediapipe/pose_detection_interpreter.h"
+#include "../utils/pose_roi.h"
+#include "../utils/tensor_caps.h"
+#include "tensor_output.h"
+
+// Values of the output tensor
+#define POSE_ROI_SIZE 5
+
+/**
+ * State of one tensor_decoder element
+ */
+typedef struct {
+  PoseDetectionInterpreter *interpreter; // Created with the anchors option
+  std::string anchors;
+  int input_size;
+  int width;
+  int height;
+  int padded_width; // 0 for the square of the largest frame side
+  int padded_height;
+} PoseDetectionDecoder;
+
+static char decoder_mode[] = "imx_pose_detection";
+
+/**
+ * Function to create the interpreter and configure it for the input tensors,
+ * false if the tensors are not supported
+ */
+static bool configure_decoder(PoseDetectionDecoder *decoder,
+                              const GstTensorsConfig *config) {
+  if (decoder->interpreter == nullptr) {
+    decoder->interpreter = new PoseDetectionInterpreter(
+        decoder->anchors.empty() ? nullptr : decoder->anchors.c_str());
+  }
+  if (!decoder->interpreter->is_configured()) {
+    std::vector<TensorSpec> outputs;
+    get_tensor_specs(*config, outputs);
+    return decoder->interpreter->configure(outputs, decoder->input_size);
+  }
+  return true;
+}
+
+static int pose_detection_init(void **private_data) {
+  *private_data = new PoseDetectionDecoder{nullptr, "", 224, 640, 480, 0, 0};
+  return TRUE;
+}
+
+static void pose_detection_exit(void **private_data) {
+  PoseDetectionDecoder *decoder =
+      static_cast<PoseDetectionDecoder *>(*private_data);
+  delete decoder->interpreter;
+  delete decoder;
+  *private_data = NULL;
+}
+
+static int pose_detection_set_option(void **private_data, int op_num,
+                                     const char *param) {
+  PoseDetectionDecoder *decoder =
+      static_cast<PoseDetectionDecoder *>(*private_data);
+  switch (op_num) {
+  case 0:
+    decoder->input_size = atoi(param);
+    return decoder->input_size > 0;
+  case 1:
+    return parse_size_option(param, decoder->width, decoder->height);
+  case 2:
+    return parse_size_option(param, decoder->padded_width,
+                             decoder->padded_height);
+  case 3:
+    // Anchors are loaded when the interpreter is created
+    if (!std::ifstream(param).is_open())
+      return FALSE;
+    if (decoder->interpreter != nullptr) {
+      delete decoder->interpreter;
+      decoder->interpreter = nullptr;
+    }
+    decoder->anchors = param;
+    return TRUE;
+  default:
+    return TRUE;
+  }
+}
+
+static GstCaps *pose_detection_get_out_caps(void **private_data,
+                                            const GstTensorsConfig *config) {
+  PoseDetectionDecoder *decoder =
+      static_cast<PoseDetectionDecoder *>(*private_data);
+  if (!configure_decoder(decoder, config))
+    return NULL;
+  return get_output_caps(config, 1, "5:1");
+}
+
+static GstFlowReturn pose_detection_decode(void **private_data,
+                                           const GstTensorsConfig *config,
+                                           const GstTensorMemory *input,
+                                           GstBuffer *outbuf) {
+  PoseDetectionDecoder *decoder =
+      static_cast<PoseDetectionDecoder *>(*private_data);
+  if (!configure_decoder(decoder, config))
+    return GST_FLOW_ERROR;
+
+  PoseDetectionInterpreter *interpreter = decoder->interpreter;
+  interpreter->decode_predictions(
+      (float *)input[interpreter->get_boxes_index()].data,
+      (float *)input[interpreter->get_scores_index()].data);
+
+  int side = std::max(decoder->width, decoder->height);
+  Keypoint padded_size(decoder->padded_width > 0 ? decoder->padded_width : side,
+                       decoder->padded_height > 0 ? decoder->padded_height
+                                                  : side);
+  BoundingBox roi;
+  float values[POSE_ROI_SIZE] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  if (get_pose_roi(interpreter->get_pose_detections(), padded_size,
+                   decoder->width, decoder->height, roi)) {
+    values[0] = 1.0;
+    values[1] = roi("xmin");
+    values[2] = roi("ymin");
+    values[3] = roi("xmax");
+    values[4] = roi("ymax");
+  }
+  return append_output_tensor(outbuf, values, POSE_ROI_SIZE);
+}
+
+static GstTensorDecoderDef pose_detection_decoder = {
+    .modename = decoder_mode,
+    .init = pose_detection_init,
+    .exit = pose_detection_exit,
+    .setOption = pose_detection_set_option,
+    .getOutCaps = pose_detection_get_out_caps,
+    .decode = pose_detection_decode,
+    .getTransformSize = NULL};
+
+/**
+ * Registration of the subplugin when the library is loaded by NNStreamer
+ */
+__attribute__((constructor)) static void init_pose_detection_decoder(void) {
+  nnstreamer_decoder_probe(&pose_detection_decoder);
+}
+
+__attribute__((destructor)) static void fini_pose_detection_decoder(void) {
+  nnstreamer_decoder_exit(pose_detection_decoder.modename);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * NNStreamer decoder subplugin of the pose landmark model
+ *
+ * tensor_decoder mode=imx_pose_landmark decodes the output tensors of the
+ * pose landmark model with PoseLandmarkInterpreter, all outputs or only the
+ * landmarks and score ones (see --landmark-outputs), and returns two float32
+ * tensors:
+ *
+ *  - [33, 5] body landmarks: x, y, z normalized to the pose region as in
+ *    Landmark, visibility and presence
+ *  - [1, 2] present, score: present is 0 when the score does not pass the
+ *    threshold, the landmarks of the last decoded pose are returned then
+ *
+ * Options:
+ *
+ *  - option1: size of the square model input (256 by default)
+ *
+ * Caps negotiation fails when the tensors are not the outputs of a pose
+ * landmark model.
+ *
+ */
+
+#include <glib.h>
+#include <gst/gst.h>
+#include <nnstreamer/nnstreamer_plugin_api.h>
+#include <nnstreamer/nnstreamer_plugin_api_decoder.h>
+
+#include <vector>
+
+#include "../mediapipe/pose_landmark_interpreter.h"
+#include "../utils/tensor_caps.h"
+#include "tensor_output.h"
+
+// Values of the output tensors
+#define NUM_BODY_LANDMARKS 33
+#define LANDMARK_SIZE 5
+
+/**
+ * State of one tensor_decoder element
+ */
+typedef struct {
+  PoseLandmarkInterpreter *interpreter;
+  int input_size;
+  float landmarks[NUM_BODY_LANDMARKS * LANDMARK_SIZE];
+} PoseLandmarkDecoder;
+
+static char decoder_mode[] = "imx_pose_landmark";
+
+/**
+ * Function to configure the interpreter for the input tensors, false if the
+ * tensors are not supported
+ */
+static bool configure_decoder(PoseLandmarkDecoder *decoder,
+                              const GstTensorsConfig *config) {
+  if (!decoder->interpreter->is_configured()) {
+    std::vector<TensorSpec> outputs;
+    get_tensor_specs(*config, outputs);
+    return decoder->interpreter->configure(outputs, decoder->input_size);
+  }
+  return true;
+}
+
+static int pose_landmark_init(void **private_data) {
+  *private_data =
+      new PoseLandmarkDecoder{new PoseLandmarkInterpreter(), 256, {}};
+  return TRUE;
+}
+
+static void pose_landmark_exit(void **private_data) {
+  PoseLandmarkDecoder *decoder =
+      static_cast<PoseLandmarkDecoder *>(*private_data);
+  delete decoder->interpreter;
+  delete decoder;
+  *private_data = NULL;
+}
+
+static int pose_landmark_set_option(void **private_data, int op_num,
+                                    const char *param) {
+  PoseLandmarkDecoder *decoder =
+      static_cast<PoseLandmarkDecoder *>(*private_data);
+  if (op_num == 0) {
+    decoder->input_size = atoi(param);
+    return decoder->input_size > 0;
+  }
+  return TRUE;
+}
+
+static GstCaps *pose_landmark_get_out_caps(void **private_data,
+                                           const GstTensorsConfig *config) {
+  PoseLandmarkDecoder *decoder =
+      static_cast<PoseLandmarkDecoder *>(*private_data);
+  if (!configure_decoder(decoder, config))
+    return NULL;
+  return get_output_caps(config, 2, "5:33,2:1");
+}
+
+static GstFlowReturn pose_landmark_decode(void **private_data,
+                                          const GstTensorsConfig *config,
+                                          const GstTensorMemory *input,
+                                          GstBuffer *outbuf) {
+  PoseLandmarkDecoder *decoder =
+      static_cast<PoseLandmarkDecoder *>(*private_data);
+  if (!configure_decoder(decoder, config))
+    return GST_FLOW_ERROR;
+
+  PoseLandmarkInterpreter *interpreter = decoder->interpreter;
+  float score = *(float *)input[interpreter->get_score_index()].data;
+  bool present = interpreter->decode_predictions(
+      (float *)input[interpreter->get_landmarks_index()].data, score);
+
+  Landmark landmark = interpreter->get_pose_landmark();
+  for (size_t i{0}; i < NUM_BODY_LANDMARKS; i++) {
+    float *values = &decoder->landmarks[i * LANDMARK_SIZE];
+    values[0] = landmark(i)["x"];
+    values[1] = landmark(i)["y"];
+    values[2] = landmark(i)["z"];
+    values[3] = landmark.get_visibility(i);
+    values[4] = landmark.get_presence(i);
+  }
+  float status[2] = {present ? 1.0f : 0.0f, score};
+
+  GstFlowReturn ret = append_output_tensor(
+      outbuf, decoder->landmarks, NUM_BODY_LANDMARKS * LANDMARK_SIZE);
+  if (ret != GST_FLOW_OK)
+    return ret;
+  return append_output_tensor(outbuf, status, 2);
+}
+
+static GstTensorDecoderDef pose_landmark_decoder = {
+    .modename = decoder_mode,
+    .init = pose_landmark_init,
+    .exit = pose_landmark_exit,
+    .setOption = pose_landmark_set_option,
+    .getOutCaps = pose_landmark_get_out_caps,
+    .decode = pose_landmark_decode,
+    .getTransformSize = NULL};
+
+/**
+ * Registration of the subplugin when the library is loaded by NNStreamer
+ */
+__attribute__((constructor)) static void init_pose_landmark_decoder(void) {
+  nnstreamer_decoder_probe(&pose_landmark_decoder);
+}
+
+__attribute__((destructor)) static void fini_pose_landmark_decoder(void) {
+  nnstreamer_decoder_exit(pose_landmark_decoder.modename);
+}
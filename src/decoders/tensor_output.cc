@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Output tensors of the decoder subplugins
+ *
+ */
+
+#include "tensor_output.h"
+
+GstCaps *get_output_caps(const GstTensorsConfig *config,
+                         const guint &num_tensors, const char *dimensions) {
+  GString *types = g_string_new("float32");
+  for (guint i{1}; i < num_tensors; i++)
+    g_string_append(types, ",float32");
+
+  // Framerate is left out when the input one is not fixed
+  gchar *framerate = (config->rate_n >= 0)
+                         ? g_strdup_printf(",framerate=%d/%d", config->rate_n,
+                                           config->rate_d)
+                         : g_strdup("");
+  gchar *description = g_strdup_printf(
+      "other/tensors,num_tensors=%u,format=static,dimensions=%s,types=%s%s",
+      num_tensors, dimensions, types->str, framerate);
+  GstCaps *caps = gst_caps_from_string(description);
+
+  g_free(description);
+  g_free(framerate);
+  g_string_free(types, TRUE);
+  return caps;
+}
+
+GstFlowReturn append_output_tensor(GstBuffer *outbuf, const float *values,
+                                   const size_t &count) {
+  gsize size = count * sizeof(float);
+  GstMemory *memory = gst_allocator_alloc(NULL, size, NULL);
+  if (memory == NULL)
+    return GST_FLOW_ERROR;
+
+  GstMapInfo info;
+  if (!gst_memory_map(memory, &info, GST_MAP_WRITE)) {
+    gst_memory_unref(memory);
+    return GST_FLOW_ERROR;
+  }
+  memcpy(info.data, values, size);
+  gst_memory_unmap(memory, &info);
+
+  gst_buffer_append_memory(outbuf, memory);
+  return GST_FLOW_OK;
+}
+
+bool parse_size_option(const char *param, int &width, int &height) {
+  gchar **values = g_strsplit(param, ":", 2);
+  bool valid = g_strv_length(values) == 2;
+  if (valid) {
+    width = atoi(values[0]);
+    height = atoi(values[1]);
+    valid = width > 0 && height > 0;
+  }
+  g_strfreev(values);
+  return valid;
+}
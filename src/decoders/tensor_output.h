@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Output tensors of the decoder subplugins
+ *
+ * The decoders return static float32 tensors, each appended to the output
+ * buffer of tensor_decoder as its own memory.
+ *
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <gst/gst.h>
+#include <nnstreamer/nnstreamer_plugin_api.h>
+
+#include <cstdlib>
+#include <cstring>
+
+// Caps of the output tensors, dimensions as in NNStreamer caps (e.g.
+// "5:33,2:1"), with the framerate of the input tensors
+GstCaps *get_output_caps(const GstTensorsConfig *config,
+                         const guint &num_tensors, const char *dimensions);
+
+// Append a float32 tensor of count values to the output buffer
+GstFlowReturn append_output_tensor(GstBuffer *outbuf, const float *values,
+                                   const size_t &count);
+
+// Parse a WIDTH:HEIGHT option
+bool parse_size_option(const char *param, int &width, int &height);
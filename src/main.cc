@@ -10,13 +10,14 @@
  * by using an NPU to accelerate two Deep Learning vision-based models.
  * Together, these models detect a person present in the scene and predict
  * 33 3D-keypoints to generate a complete body landmark. From this
- * landmark, a K-NN pose classifier is built to differenciate between two
- * different body poses: 'Squat-Down' and 'Squat-Up'. A counter shows the
- * number of repetitions the pearson has done for the 'Squat' fitness exercise.
+ * landmark, a K-NN pose classifier is built to differenciate between the
+ * body poses of the registered exercises (by default 'Squat-Down' and
+ * 'Squat-Up'). A counter shows the number of repetitions the pearson has done
+ * for the active fitness exercise.
  *
- * The solution is limited to classify and count only the 'squats' fitness
- * exercise and the repetition counting is set to 12 repetitions in an infinite
- * loop.
+ * Exercises are loaded from an optional configuration file. Each exercise
+ * defines its pose classes, counter thresholds and the number of repetitions
+ * of one set, which is counted in an infinite loop.
  *
  */
 
@@ -30,25 +31,44 @@
 #include <gst/gstelement.h>
 #include <gst/gstpad.h>
 #include <gst/gstpipeline.h>
+#include <gst/video/gstvideometa.h>
 #include <gst/video/video-info.h>
+#include <gst/video/video-overlay-composition.h>
 #include <nnstreamer/nnstreamer_util.h>
 
+#include <atomic>
 #include <csignal>
+#include <future>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 // cargs for argument parsing
 #include "cargs/cargs.h"
 
-// Classifier for squat pose
+// Classifier for exercise poses
+#include "classifier/classification_worker.h"
+#include "classifier/distance_model.h"
+#include "classifier/exercise_engine.h"
+#include "classifier/exercise_registry.h"
+#include "classifier/mlp_classifier.h"
 #include "classifier/pose_classification.h"
-#include "classifier/repetition_counter.h"
 
 // Mediapipe interpreters
 #include "mediapipe/pose_detection_interpreter.h"
 #include "mediapipe/pose_landmark_interpreter.h"
 #include "utils/ema_filter.h"
+#include "utils/idle_monitor.h"
+#include "utils/metrics.h"
+#include "utils/metrics_server.h"
+#include "utils/model_cascade.h"
+#include "utils/overlay_layer.h"
+#include "utils/rate_controller.h"
+#include "utils/pose_roi.h"
+#include "utils/startup_trace.h"
+#include "utils/tensor_caps.h"
+#include "utils/thread_policy.h"
 
 #define WIDTH 640
 #define HEIGHT 480
@@ -57,6 +77,14 @@
 #define FONT_SIZE_RUNTIME 35
 #define INIT_POSITION_RUNTIME_STR 10
 
+// Areas of the overlay layers
+#define HUD_WIDTH 400
+#define HUD_HEIGHT 45
+#define COUNT_WIDTH 110
+#define COUNT_HEIGHT 60
+#define EXERCISE_HEIGHT 80
+#define POSE_MARGIN 4
+
 /**
  * Configuration for args
  */
@@ -87,6 +115,14 @@ static struct cag_option options[] = {
      .value_name = "./path/to/model.tflite",
      .description = "Path to pose landmark TFlite model"},
 
+    {.identifier = 'q',
+     .access_letters = "q",
+     .access_name = "pose-landmark-model-accurate",
+     .value_name = "./path/to/model.tflite",
+     .description = "Path to a more accurate pose landmark TFlite model, run "
+                    "instead of the other one on hard frames and when the "
+                    "frame period allows it (optional)"},
+
     {.identifier = 'e',
      .access_letters = "e",
      .access_name = "pose-embeddings",
@@ -97,7 +133,137 @@ static struct cag_option options[] = {
      .access_letters = "a",
      .access_name = "anchors",
      .value_name = "./path/to/anchors.txt",
-     .description = "Path to anchors file"},
+     .description = "Path to anchors file (optional, anchors of the 224x224 "
+                    "pose detection model are built in)"},
+
+    {.identifier = 'x',
+     .access_letters = "x",
+     .access_name = "exercises",
+     .value_name = "./path/to/exercises.csv",
+     .description = "Path to exercises configuration (optional, squats by "
+                    "default, up to 32 pose classes in total)"},
+
+    {.identifier = 'z',
+     .access_letters = "z",
+     .access_name = "classifier",
+     .value_name = "knn|./path/to/classifier.csv",
+     .description = "Pose classifier, k-NN over the pose embeddings or a "
+                    "model trained by train_classifier.py (optional, knn by "
+                    "default)"},
+
+    {.identifier = 'c',
+     .access_letters = "c",
+     .access_name = "classifier-threads",
+     .value_name = "N|auto",
+     .description = "Threads for the pose classifier scan (optional, 1 by "
+                    "default, auto for large pose embeddings)"},
+
+    {.identifier = 'v',
+     .access_letters = "v",
+     .access_name = "classifier-precision",
+     .value_name = "float|fp16|int8",
+     .description = "Precision of the pose classifier scan, candidates are "
+                    "ranked again in float (optional, float by default)"},
+
+    {.identifier = 'y',
+     .access_letters = "y",
+     .access_name = "distance-model",
+     .value_name = "./path/to/model.tflite",
+     .description = "Path to pose sample distances TFlite model, run on the "
+                    "NPU between the pose models (optional)"},
+
+    {.identifier = 'n',
+     .access_letters = "n",
+     .access_name = "npu-cache-dir",
+     .value_name = "./path/to/cache",
+     .description = "Directory to cache the compiled NPU graphs between runs "
+                    "(optional, i.MX8MP only)"},
+
+    {.identifier = 'w',
+     .access_letters = "w",
+     .access_name = "no-warmup",
+     .value_name = NULL,
+     .description = "Skip the models warm-up before the camera goes live"},
+
+    {.identifier = 'm',
+     .access_letters = "m",
+     .access_name = "metrics",
+     .value_name = "PORT|unix:/path/to/socket",
+     .description = "Serve metrics in Prometheus format on a local TCP port "
+                    "or Unix socket (optional)"},
+
+    {.identifier = 'j',
+     .access_letters = "j",
+     .access_name = "metrics-log",
+     .value_name = "SECONDS",
+     .description = "Print metrics as JSON every SECONDS (optional)"},
+
+    {.identifier = 'r',
+     .access_letters = "r",
+     .access_name = "inference-rate",
+     .value_name = "auto|30|15|10",
+     .description = "Rate of the pose detection and landmark inferences in "
+                    "Hz (optional, auto by default)"},
+
+    {.identifier = 'b',
+     .access_letters = "b",
+     .access_name = "latency-budget",
+     .value_name = "MS",
+     .description = "End-to-end latency budget of the auto inference rate "
+                    "(optional, 100 ms by default)"},
+
+    {.identifier = 'u',
+     .access_letters = "u",
+     .access_name = "idle-timeout",
+     .value_name = "SECONDS",
+     .description = "Time without pose before the low-power idle mode, 0 "
+                    "to disable (optional, 30 s by default)"},
+
+    {.identifier = 'o',
+     .access_letters = "o",
+     .access_name = "crop-mode",
+     .value_name = "meta|videocrop",
+     .description = "How the pose is cropped for landmarks: crop meta "
+                    "honored by the converter, or videocrop element "
+                    "(optional, meta by default)"},
+
+    {.identifier = 'k',
+     .access_letters = "k",
+     .access_name = "thread-policy",
+     .value_name = "./path/to/file",
+     .description = "Cores and SCHED_FIFO priorities of the streaming "
+                    "threads (optional)"},
+
+    {.identifier = 's',
+     .access_letters = "s",
+     .access_name = "detection-preprocess",
+     .value_name = "letterbox|stretch",
+     .description = "How frames are fit to the pose detection input: padded "
+                    "to keep the aspect ratio, or stretched (optional, "
+                    "letterbox by default)"},
+
+    {.identifier = 'i',
+     .access_letters = "i",
+     .access_name = "detection-input-size",
+     .value_name = "PIXELS",
+     .description = "Input size of the pose detection model (optional, 224 "
+                    "by default)"},
+
+    {.identifier = 'g',
+     .access_letters = "g",
+     .access_name = "landmark-input-size",
+     .value_name = "PIXELS",
+     .description = "Input size of the pose landmark model (optional, 256 "
+                    "by default)"},
+
+    {.identifier = 'f',
+     .access_letters = "f",
+     .access_name = "landmark-outputs",
+     .value_name = "auto|all|COMBINATION",
+     .description = "Pose landmark model outputs pushed to the application: "
+                    "landmarks and score found at warm-up, all outputs, or "
+                    "a tensor_filter output-combination (optional, auto by "
+                    "default)"},
 
     {.identifier = 'h',
      .access_letters = "h",
@@ -114,17 +280,81 @@ struct configuration {
   bool pose_detection_exists;
   bool pose_landmark_exists;
   bool pose_embeddings_exists;
-  bool anchors_exists;
 };
 
 /**
- * Define structure to handle cairo overlay caps
+ * Define structure to handle overlay caps
  */
 typedef struct {
   gboolean valid;
   GstVideoInfo vinfo;
 } CairoOverlayState;
 
+/**
+ * Define the structure to count the frames dropped by a leaky queue
+ */
+typedef struct {
+  const char *name;
+  GstElement *queue;
+  Metrics::Metric *input_frames;
+  Metrics::Metric *output_frames;
+  Metrics::Metric *dropped_frames;
+} QueueMetrics;
+
+/**
+ * Define the metrics exported by the application
+ */
+typedef struct {
+  Metrics::Metric *frames_captured;
+  QueueMetrics queues[3];
+  Metrics::Metric *qos_processed;
+  Metrics::Metric *qos_dropped;
+  Metrics::Metric *display_fps;
+  Metrics::Metric *display_average_fps;
+  Metrics::Metric *display_drop_rate;
+  Metrics::Metric *detection_latency;
+  Metrics::Metric *landmark_latency;
+  Metrics::Metric *landmark_pruned_bytes;
+  Metrics::Metric *landmark_accurate_latency;
+  Metrics::Metric *landmark_model_frames[2]; // Per cascade model
+  Metrics::Metric *classification_latency;
+  Metrics::Metric *classification_dropped;
+  Metrics::Metric *classification_stale;
+  Metrics::Metric *classification_gated;
+  Metrics::Metric *frames_analyzed;
+  Metrics::Metric *frames_person_present;
+  Metrics::Metric *person_present_ratio;
+  Metrics::Metric *inference_rate;
+  Metrics::Metric *inference_rate_changes;
+  Metrics::Metric *idle;
+  Metrics::Metric *idle_wakeups;
+  Metrics::Metric *wake_latency;
+  Metrics::Metric *landmark_interval;
+  Metrics::Metric *landmark_jitter;
+  Metrics::Metric *landmark_skipped;
+  Metrics::Metric *main_thread_cpu;
+  std::vector<Metrics::Metric *> repetitions; // One per exercise
+
+  // Values at the previous update, for the person present ratio
+  double last_frames_analyzed;
+  double last_frames_person_present;
+
+  // Values at the previous update, for the inference rate controller
+  double last_qos_processed;
+  double last_qos_dropped;
+  double last_detection_input;
+  double last_detection_dropped;
+
+  // Landmark frame interval smoothing, for the jitter
+  gint64 last_landmark_time; // us
+  double landmark_interval_mean;
+  double landmark_interval_jitter;
+
+  // Main thread CPU time at the previous update
+  double last_main_thread_cpu; // s
+  double last_main_thread_time; // s
+} AppMetrics;
+
 /**
  * Define the data structure to handle application
  */
@@ -141,15 +371,28 @@ typedef struct _appdata {
   GstElement *secondary_pipeline;
   GstElement *appsrc;
   GstElement *videocrop;
+  bool crop_meta; // Crop with GstVideoCropMeta instead of videocrop
+  bool letterbox; // Pad frames to the pose detection input aspect ratio
+  int detection_input_size;
+  int landmark_input_size;
   GstElement *tensor_sink_landmark;
   GstElement *tensor_filter_landmark;
-  guint source_id;
+  GstElement *landmark_selector; // Cascade only
+  GstPad *landmark_pads[2];      // Selector pad of each cascade model
+  GstElement *tensor_sink_landmark_accurate;
+  GstElement *tensor_filter_landmark_accurate;
+  std::atomic<bool> appsrc_ready; // Set by need-data, cleared by enough-data
 
   GstBus *bus;
   GMainLoop *main_loop;
   GMutex g_mutex;
 
   CairoOverlayState overlay_state;
+  OverlayLayer *hud_layer;      // Frame info, latencies and rate
+  OverlayLayer *exercise_layer; // Exercise labels and confidence graph
+  OverlayLayer *count_layer;    // Repetitions count
+  OverlayLayer *pose_layer;     // Pose box and skeleton
+  GstVideoOverlayComposition *composition;
 
   BoundingBox pose;
   Landmark landmark;
@@ -169,16 +412,35 @@ typedef struct _appdata {
   // Define Interpreters
   PoseDetectionInterpreter *pose_detection_interpreter;
   PoseLandmarkInterpreter *pose_landmark_interpreter;
+  PoseLandmarkInterpreter *pose_landmark_interpreter_accurate;
+  ModelCascade *model_cascade; // nullptr without accurate landmark model
+  ModelCascade::Model landmark_model; // Model of the active selector pad
+  size_t landmark_pruned_bytes[2];    // Outputs left out, per cascade model
   guint inference_time_pose;
   guint inference_time_landmark;
 
-  EMAFilter *filter_classification;
   Filter *filter_bbox;
 
   ClassificationResult result;
-  RepetitionCounter *counter;
 
-  PoseClassifier *classifier;
+  EmbeddingClassifier *classifier;
+  ExerciseEngine *engine;
+  ClassificationWorker *classification_worker;
+
+  StartupTrace *startup_trace;
+
+  Metrics *metrics;
+  MetricsServer *metrics_server;
+  AppMetrics app_metrics;
+  guint metrics_source_id;
+  guint events_source_id;
+  guint metrics_log_interval; // Seconds, 0 if disabled
+  guint metrics_log_elapsed;
+
+  RateController *rate_controller;
+  IdleMonitor *idle_monitor;
+
+  ThreadPolicy *thread_policy;
 
 } AppData;
 
@@ -194,9 +456,16 @@ static void bus_message_callback(GstBus *bus, GstMessage *message,
                                  AppData *data);
 
 /**
- * Get the caps information that need cairooverlay
+ * Function called from the posting thread to apply the thread policy
+ */
+static GstBusSyncReply bus_sync_handler(GstBus *bus, GstMessage *message,
+                                        gpointer user_data);
+
+/**
+ * Get the caps information that need overlaycomposition
  */
 static void configure_overlay_callback(GstElement *overlay, GstCaps *caps,
+                                       guint window_width, guint window_height,
                                        AppData *data);
 
 /**
@@ -205,25 +474,88 @@ static void configure_overlay_callback(GstElement *overlay, GstCaps *caps,
 static void new_pose_detection(GstElement *sink, GstBuffer *gstbuffer,
                                AppData *data);
 
+/**
+ * Function to read the output tensors negotiated on a tensor_sink
+ */
+static bool get_tensors_info(GstElement *sink,
+                             std::vector<TensorSpec> &tensors);
+
+/**
+ * Function to run a dummy inference on a model before the camera goes live
+ */
+static void warm_up_model(const gchar *model, const gchar *delegate,
+                          const int &input_size, const gchar *transform,
+                          std::vector<TensorSpec> &outputs);
+
+/**
+ * Function to register the metrics of the application
+ */
+static void setup_metrics(AppData *data);
+
+/**
+ * Function to count the buffers going through a pad
+ */
+static GstPadProbeReturn count_buffers_probe(GstPad *pad,
+                                             GstPadProbeInfo *info,
+                                             gpointer user_data);
+
+/**
+ * Function to add the counting probes on both sides of a leaky queue
+ */
+static void add_queue_probes(QueueMetrics *queue_metrics, GstBin *bin);
+
+/**
+ * Function to handle fpsdisplaysink callback for FPS measurements
+ */
+static void fps_measurements(GstElement *fps_sink, gdouble fps,
+                             gdouble drop_rate, gdouble average_fps,
+                             AppData *data);
+
+/**
+ * Function to update the polled metrics and print the JSON log
+ */
+static gboolean update_metrics(AppData *data);
+
+/**
+ * Function to update the inference rate from the latest metrics
+ */
+static void update_inference_rate(AppData *data);
+
+/**
+ * Function to handle the repetition events of the classification worker
+ */
+static gboolean handle_repetition_events(AppData *data);
+
+/**
+ * Function to skip the pose detection of frames above the inference rate
+ */
+static GstPadProbeReturn detection_rate_probe(GstPad *pad,
+                                              GstPadProbeInfo *info,
+                                              AppData *data);
+
 /**
  * Function to handle appsink callback for pose landmarks
  */
-static GstFlowReturn appsink_new_sample(GstElement *appsink, AppData *data);
+static GstFlowReturn appsink_new_sample(GstAppSink *appsink,
+                                        gpointer user_data);
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to handle appsrc callback when it needs data
  */
-static void start_feed(GstElement *appsrc, guint size, AppData *data);
+static void appsrc_need_data(GstAppSrc *appsrc, guint size,
+                             gpointer user_data);
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to handle appsrc callback when its queue is full
  */
-static void stop_feed(GstElement *appsrc, AppData *data);
+static void appsrc_enough_data(GstAppSrc *appsrc, gpointer user_data);
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to route each frame to the landmark model chosen by the cascade
  */
-static gboolean push_data(AppData *data);
+static GstPadProbeReturn landmark_model_probe(GstPad *pad,
+                                              GstPadProbeInfo *info,
+                                              AppData *data);
 
 /**
  * Function to handle tensor_sink callback for pose landmarks
@@ -232,10 +564,20 @@ static void new_pose_landmarks(GstElement *sink, GstBuffer *gstbuffer,
                                AppData *data);
 
 /**
- * Function to handle cairooverlay callback to draw results
+ * Function to compute the margin between the two most confident classes
+ */
+static float get_class_margin(const ClassificationResult &result);
+
+/**
+ * Function to handle overlaycomposition callback to draw results
+ */
+static GstVideoOverlayComposition *
+draw_overlay(GstElement *overlay, GstSample *sample, AppData *data);
+
+/**
+ * Function to update the filtered pose region from the pose detections
  */
-static void draw_overlay(GstElement *overlay, cairo_t *cr, guint64 timestamp,
-                         guint64 duration, AppData *data);
+static bool update_pose_roi(AppData *data);
 
 /**
  * Funtion to compute preprocess of input frame
@@ -258,6 +600,9 @@ static AppData data = {};
  * Main function that runs the demo
  */
 int main(int argc, char *argv[]) {
+  // Startup phases are timed from here
+  StartupTrace startup_trace;
+  data.startup_trace = &startup_trace;
 
   // Variables for arguments
   char identifier;
@@ -265,10 +610,29 @@ int main(int argc, char *argv[]) {
   const gchar *target = nullptr;
   const gchar *pose_detection_model = nullptr;
   const gchar *pose_landmark_model = nullptr;
+  const gchar *pose_landmark_model_accurate = nullptr;
   const char *pose_embeddings = nullptr;
   const gchar *anchors = nullptr;
+  const char *exercises = nullptr;
+  const char *classifier_backend = nullptr;
+  const char *classifier_threads = nullptr;
+  const char *classifier_precision = nullptr;
+  const gchar *distance_model = nullptr;
+  const gchar *npu_cache_dir = nullptr;
+  bool warmup = true;
+  const char *metrics_address = nullptr;
+  const char *metrics_log = nullptr;
+  const char *inference_rate = nullptr;
+  const char *latency_budget = nullptr;
+  const char *idle_timeout = nullptr;
+  const char *crop_mode = nullptr;
+  const char *thread_policy = nullptr;
+  const char *detection_preprocess = nullptr;
+  const char *detection_input_size = nullptr;
+  const char *landmark_input_size = nullptr;
+  const char *landmark_outputs = nullptr;
   cag_option_context context;
-  struct configuration config = {false, false, false, false, false, false};
+  struct configuration config = {false, false, false, false, false};
 
   cag_option_prepare(&context, options, CAG_ARRAY_SIZE(options), argc, argv);
   while (cag_option_fetch(&context)) {
@@ -290,14 +654,70 @@ int main(int argc, char *argv[]) {
       config.pose_landmark_exists = true;
       pose_landmark_model = cag_option_get_value(&context);
       break;
+    case 'q':
+      pose_landmark_model_accurate = cag_option_get_value(&context);
+      break;
     case 'e':
       config.pose_embeddings_exists = true;
       pose_embeddings = cag_option_get_value(&context);
       break;
     case 'a':
-      config.anchors_exists = true;
       anchors = cag_option_get_value(&context);
       break;
+    case 'x':
+      exercises = cag_option_get_value(&context);
+      break;
+    case 'z':
+      classifier_backend = cag_option_get_value(&context);
+      break;
+    case 'c':
+      classifier_threads = cag_option_get_value(&context);
+      break;
+    case 'v':
+      classifier_precision = cag_option_get_value(&context);
+      break;
+    case 'y':
+      distance_model = cag_option_get_value(&context);
+      break;
+    case 'n':
+      npu_cache_dir = cag_option_get_value(&context);
+      break;
+    case 'w':
+      warmup = false;
+      break;
+    case 'm':
+      metrics_address = cag_option_get_value(&context);
+      break;
+    case 'j':
+      metrics_log = cag_option_get_value(&context);
+      break;
+    case 'r':
+      inference_rate = cag_option_get_value(&context);
+      break;
+    case 'b':
+      latency_budget = cag_option_get_value(&context);
+      break;
+    case 'u':
+      idle_timeout = cag_option_get_value(&context);
+      break;
+    case 'o':
+      crop_mode = cag_option_get_value(&context);
+      break;
+    case 'k':
+      thread_policy = cag_option_get_value(&context);
+      break;
+    case 's':
+      detection_preprocess = cag_option_get_value(&context);
+      break;
+    case 'i':
+      detection_input_size = cag_option_get_value(&context);
+      break;
+    case 'g':
+      landmark_input_size = cag_option_get_value(&context);
+      break;
+    case 'f':
+      landmark_outputs = cag_option_get_value(&context);
+      break;
     case 'h':
       printf("Usage: imx-smart-fitness [OPTION]...\n");
       printf("i.MX Smart Fitness Application.\n\n");
@@ -330,18 +750,149 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  if (!config.pose_embeddings_exists) {
+  // A trained classifier model replaces the k-NN over the pose embeddings
+  const char *classifier_model = nullptr;
+  if (classifier_backend != nullptr && strcmp(classifier_backend, "knn") != 0)
+    classifier_model = classifier_backend;
+
+  if (!config.pose_embeddings_exists && classifier_model == nullptr) {
     std::cerr << "Please provide the path to the pose embeddings file.\n"
                  "Run \'./imx-smart-fitness --help\' for more information.\n";
     return EXIT_FAILURE;
   }
 
-  if (!config.anchors_exists) {
-    std::cerr << "Please provide the path to the anchors file.\n"
-                 "Run \'./imx-smart-fitness --help\' for more information.\n";
+  // Number of threads for the classifier scan, 0 for auto
+  size_t num_threads = 1;
+  if (classifier_threads != nullptr) {
+    if (strcmp(classifier_threads, "auto") == 0) {
+      num_threads = 0;
+    } else if (atoi(classifier_threads) > 0) {
+      num_threads = atoi(classifier_threads);
+    } else {
+      std::cerr << "Please provide a valid number of classifier threads.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Precision of the classifier scan
+  QuantizedIndex::Precision precision = QuantizedIndex::FLOAT;
+  if (classifier_precision != nullptr &&
+      !QuantizedIndex::parse_precision(classifier_precision, precision)) {
+    std::cerr << "Please provide a valid classifier precision.\n"
+                 "Run \'./imx-smart-fitness --help\' for more "
+                 "information.\n";
+    return EXIT_FAILURE;
+  }
+
+  // Interval of the JSON metrics log
+  guint metrics_log_interval = 0;
+  if (metrics_log != nullptr) {
+    if (atoi(metrics_log) > 0) {
+      metrics_log_interval = atoi(metrics_log);
+    } else {
+      std::cerr << "Please provide a valid metrics log interval.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Inference rate, fixed or chosen at runtime within the latency budget
+  float budget = 100.0;
+  if (latency_budget != nullptr) {
+    if (atof(latency_budget) > 0) {
+      budget = atof(latency_budget);
+    } else {
+      std::cerr << "Please provide a valid latency budget.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+  // Idle mode after some time without pose
+  float timeout = 30.0;
+  if (idle_timeout != nullptr) {
+    char *end = nullptr;
+    timeout = strtof(idle_timeout, &end);
+    if (end == idle_timeout || *end != '\0' || timeout < 0) {
+      std::cerr << "Please provide a valid idle timeout.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+  data.idle_monitor = new IdleMonitor(timeout, 30.0);
+
+  if (inference_rate == nullptr || strcmp(inference_rate, "auto") == 0) {
+    data.rate_controller = new RateController(30.0, budget);
+  } else if (atof(inference_rate) > 0) {
+    data.rate_controller =
+        new RateController(30.0, budget, atof(inference_rate));
+  } else {
+    std::cerr << "Please provide a valid inference rate.\n"
+                 "Run \'./imx-smart-fitness --help\' for more "
+                 "information.\n";
     return EXIT_FAILURE;
   }
 
+  // Pose crop for landmarks
+  data.crop_meta = true;
+  if (crop_mode != nullptr) {
+    if (strcmp(crop_mode, "videocrop") == 0) {
+      data.crop_meta = false;
+    } else if (strcmp(crop_mode, "meta") != 0) {
+      std::cerr << "Please provide a valid crop mode.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Pose detection input fitting
+  data.letterbox = true;
+  if (detection_preprocess != nullptr) {
+    if (strcmp(detection_preprocess, "stretch") == 0) {
+      data.letterbox = false;
+    } else if (strcmp(detection_preprocess, "letterbox") != 0) {
+      std::cerr << "Please provide a valid detection preprocess.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Square input size of the models, output tensors are read from the
+  // negotiated caps
+  data.detection_input_size = 224;
+  if (detection_input_size != nullptr) {
+    if (atoi(detection_input_size) > 0) {
+      data.detection_input_size = atoi(detection_input_size);
+    } else {
+      std::cerr << "Please provide a valid pose detection input size.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+  data.landmark_input_size = 256;
+  if (landmark_input_size != nullptr) {
+    if (atoi(landmark_input_size) > 0) {
+      data.landmark_input_size = atoi(landmark_input_size);
+    } else {
+      std::cerr << "Please provide a valid pose landmark input size.\n"
+                   "Run \'./imx-smart-fitness --help\' for more "
+                   "information.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Streaming threads float freely across the cores without a policy
+  data.thread_policy = (thread_policy != nullptr)
+                           ? new ThreadPolicy(thread_policy)
+                           : new ThreadPolicy();
+
   // Define delegate and converter for selected target
   const char *delegate = nullptr;
   const char *nxp_converter = nullptr;
@@ -355,11 +906,24 @@ int main(int argc, char *argv[]) {
     g_printerr("Target not supported!\n");
   }
 
+  // Compiled graphs are cached by the VX delegate, Ethos-U models are
+  // already compiled offline by Vela
+  if (npu_cache_dir != nullptr) {
+    if (strcmp(target, "i.MX8MP") == 0) {
+      g_setenv("VIV_VX_ENABLE_CACHE_GRAPH_BINARY", "1", TRUE);
+      g_setenv("VIV_VX_CACHE_BINARY_GRAPH_DIR", npu_cache_dir, TRUE);
+    } else {
+      g_print("NPU graph cache not supported on %s, ignoring...\n", target);
+    }
+  }
+
   // Register signal SIGINT and signal handler
   signal(SIGINT, sigint_handler);
 
   // Initialize GStreamer
+  size_t phase = startup_trace.begin("gstreamer init");
   gst_init(&argc, &argv);
+  startup_trace.end(phase);
 
   /* Initialize elements to nullptr */
 
@@ -370,6 +934,11 @@ int main(int argc, char *argv[]) {
   data.appsink = nullptr;
   data.overlay = nullptr;
   data.wayland_sink = nullptr;
+  data.hud_layer = new OverlayLayer();
+  data.exercise_layer = new OverlayLayer();
+  data.count_layer = new OverlayLayer();
+  data.pose_layer = new OverlayLayer();
+  data.composition = nullptr;
 
   // Secondary pipeline elements
   data.secondary_pipeline = nullptr;
@@ -377,16 +946,51 @@ int main(int argc, char *argv[]) {
   data.videocrop = nullptr;
   data.tensor_sink_landmark = nullptr;
   data.tensor_filter_landmark = nullptr;
-  data.source_id = 0;
+  data.landmark_selector = nullptr;
+  data.landmark_pads[0] = nullptr;
+  data.landmark_pads[1] = nullptr;
+  data.tensor_sink_landmark_accurate = nullptr;
+  data.tensor_filter_landmark_accurate = nullptr;
+  data.appsrc_ready = false;
 
   // Shared elements
   data.bus = nullptr;
   data.main_loop = nullptr;
   g_mutex_init(&data.g_mutex);
 
+  // Anchors and pose samples are loaded while the models are warmed up and
+  // the pipelines are built
+  std::future<PoseDetectionInterpreter *> detection_interpreter =
+      std::async(std::launch::async, [anchors] {
+        size_t phase = data.startup_trace->begin("anchors load");
+        PoseDetectionInterpreter *interpreter =
+            new PoseDetectionInterpreter(anchors);
+        data.startup_trace->end(phase);
+        return interpreter;
+      });
+  std::future<EmbeddingClassifier *> classifier =
+      std::async(std::launch::async, [pose_embeddings, classifier_model,
+                                      num_threads, precision] {
+        size_t phase = data.startup_trace->begin("classifier index build");
+        EmbeddingClassifier *pose_classifier =
+            (classifier_model != nullptr)
+                ? static_cast<EmbeddingClassifier *>(
+                      new MlpClassifier(classifier_model))
+                : new PoseClassifier(pose_embeddings, num_threads, precision);
+        data.startup_trace->end(phase);
+        return pose_classifier;
+      });
+
   // MediaPipe interpreters
-  data.pose_detection_interpreter = new PoseDetectionInterpreter(anchors);
+  data.pose_detection_interpreter = nullptr;
   data.pose_landmark_interpreter = new PoseLandmarkInterpreter();
+  data.pose_landmark_interpreter_accurate = nullptr;
+  data.model_cascade = nullptr;
+  data.landmark_model = ModelCascade::FAST;
+  if (pose_landmark_model_accurate != nullptr) {
+    data.pose_landmark_interpreter_accurate = new PoseLandmarkInterpreter();
+    data.model_cascade = new ModelCascade();
+  }
   data.inference_time_pose = 0;
   data.inference_time_landmark = 0;
   data.pose_detected = false;
@@ -401,11 +1005,60 @@ int main(int argc, char *argv[]) {
   data.roi_width_bbox = 0;
   data.roi_height_bbox = 0;
 
-  data.filter_classification = new EMAFilter();
   data.filter_bbox = new Filter();
-  data.counter = new RepetitionCounter("squats_down");
-
-  data.classifier = new PoseClassifier(pose_embeddings);
+  data.classifier = nullptr;
+  data.engine = nullptr;
+  data.classification_worker = nullptr;
+
+  // First inferences pay for the NPU graph compilation, run them now.
+  // With --npu-cache-dir, the compiled graphs are also stored on disk and
+  // reused by the pipelines and by the next runs.
+  // Only the landmarks and score tensors are pushed to the application, so
+  // the other outputs are not copied nor mapped. Their tensors are found by
+  // shape in the outputs negotiated by the warm-up inference.
+  std::string landmark_combination[2];
+  bool landmark_outputs_auto =
+      (landmark_outputs == nullptr || strcmp(landmark_outputs, "auto") == 0);
+  if (!landmark_outputs_auto && strcmp(landmark_outputs, "all") != 0) {
+    landmark_combination[ModelCascade::FAST] = landmark_outputs;
+    landmark_combination[ModelCascade::ACCURATE] = landmark_outputs;
+  }
+  data.landmark_pruned_bytes[ModelCascade::FAST] = 0;
+  data.landmark_pruned_bytes[ModelCascade::ACCURATE] = 0;
+
+  if (warmup) {
+    std::vector<TensorSpec> outputs;
+    phase = startup_trace.begin("models warm-up");
+    warm_up_model(pose_detection_model, delegate, data.detection_input_size,
+                  "typecast:float32,div:255.0,add:-0.5,mul:2.0", outputs);
+    warm_up_model(pose_landmark_model, delegate, data.landmark_input_size,
+                  "typecast:float32,div:255.0", outputs);
+    if (landmark_outputs_auto) {
+      landmark_combination[ModelCascade::FAST] =
+          data.pose_landmark_interpreter->get_output_combination(
+              outputs, data.landmark_pruned_bytes[ModelCascade::FAST]);
+    }
+    if (data.model_cascade != nullptr) {
+      warm_up_model(pose_landmark_model_accurate, delegate,
+                    data.landmark_input_size, "typecast:float32,div:255.0",
+                    outputs);
+      if (landmark_outputs_auto) {
+        landmark_combination[ModelCascade::ACCURATE] =
+            data.pose_landmark_interpreter_accurate->get_output_combination(
+                outputs, data.landmark_pruned_bytes[ModelCascade::ACCURATE]);
+      }
+    }
+    startup_trace.end(phase);
+  }
+  for (size_t i{0}; i < 2; i++) {
+    if (!landmark_combination[i].empty()) {
+      g_print("Pose landmark outputs (%s model): %s, %.1f KiB per frame left "
+              "out\n",
+              (i == ModelCascade::FAST ? "fast" : "accurate"),
+              landmark_combination[i].c_str(),
+              data.landmark_pruned_bytes[i] / 1024.0);
+    }
+  }
 
   // Video input size and scaled size
   memset(data.pad_img_shape, 0, 2 * sizeof(int));
@@ -416,6 +1069,14 @@ int main(int argc, char *argv[]) {
   preprocess_input_frame(video_width, video_height, scaled_width, scaled_height,
                          &data);
 
+  // Letterbox padding is added at the bottom or right of the frame
+  gchar *detection_padding =
+      data.letterbox ? g_strdup_printf("videobox autocrop=false bottom=%d "
+                                       "right=%d ! ",
+                                       video_height - data.pad_img_shape[1],
+                                       video_width - data.pad_img_shape[0])
+                     : g_strdup("");
+
   // Create GLib main loop and set it to run
   data.main_loop = g_main_loop_new(NULL, FALSE);
   if (!data.main_loop) {
@@ -425,13 +1086,13 @@ int main(int argc, char *argv[]) {
 
   // Create pipeline
   gchar *pipeline_cmd = g_strdup_printf(
-      "v4l2src device=%s ! "
+      "v4l2src name=camera device=%s ! "
       "video/x-raw,width=%d,height=%d,framerate=30/1,format=YUY2 ! "
       "tee name=t "
       // Pose detection
-      "t. ! queue max-size-buffers=1 leaky=1 ! "
-      "videobox autocrop=false bottom=-160 ! "
-      "%s ! video/x-raw,width=224,height=224 ! "
+      "t. ! queue name=queue_detection max-size-buffers=1 leaky=1 ! "
+      "%s"
+      "%s ! video/x-raw,width=%d,height=%d ! "
       "videoconvert ! video/x-raw,format=RGB ! "
       "tensor_converter ! "
       "tensor_transform mode=arithmetic "
@@ -443,47 +1104,173 @@ int main(int argc, char *argv[]) {
       "name=tensor_filter_pose ! "
       "tensor_sink name=tensor_sink "
       // Pose landmarks
-      "t. ! queue max-size-buffers=1 leaky=2 ! "
+      "t. ! queue name=queue_landmark max-size-buffers=1 leaky=2 ! "
       "appsink name=appsink max-buffers=1 "
-      // Draw results on screen
-      "t. ! queue max-size-buffers=1 leaky=1 ! %s ! "
-      "cairooverlay name=overlay ! "
+      // Draw results on screen, blended by the sink when it supports the
+      // overlay composition meta
+      "t. ! queue name=queue_display max-size-buffers=1 leaky=1 ! "
+      "overlaycomposition name=overlay ! "
       "fpsdisplaysink name=fps_sink text-overlay=false video-sink=waylandsink "
       "sync=false",
-      camera, video_width, video_height, nxp_converter, pose_detection_model,
-      delegate, nxp_converter);
-
-  // Create secondary pipeline for pose landmarks
+      camera, video_width, video_height, detection_padding, nxp_converter,
+      data.detection_input_size, data.detection_input_size,
+      pose_detection_model, delegate);
+  g_free(detection_padding);
+
+  // With a cascade, both landmark models sit behind an output-selector and
+  // each frame only runs through the model chosen for it
+  gchar *landmark_models =
+      (data.model_cascade != nullptr)
+          ? g_strdup_printf(
+                "output-selector name=landmark_selector "
+                "landmark_selector. ! "
+                "tensor_filter framework=tensorflow-lite "
+                "model=%s "
+                "accelerator=true:npu "
+                "custom=Delegate:External,ExtDelegateLib:%s "
+                "name=tensor_filter_landmark ! "
+                "tensor_sink name=second_tensor_sink "
+                "landmark_selector. ! "
+                "tensor_filter framework=tensorflow-lite "
+                "model=%s "
+                "accelerator=true:npu "
+                "custom=Delegate:External,ExtDelegateLib:%s "
+                "name=tensor_filter_landmark_accurate ! "
+                "tensor_sink name=second_tensor_sink_accurate",
+                pose_landmark_model, delegate, pose_landmark_model_accurate,
+                delegate)
+          : g_strdup_printf("tensor_filter framework=tensorflow-lite "
+                            "model=%s "
+                            "accelerator=true:npu "
+                            "custom=Delegate:External,ExtDelegateLib:%s "
+                            "name=tensor_filter_landmark ! "
+                            "tensor_sink name=second_tensor_sink",
+                            pose_landmark_model, delegate);
+
+  // Create secondary pipeline for pose landmarks. With crop meta, the
+  // converter crops and scales the pose in a single pass, so a new crop
+  // never renegotiates the pipeline.
   gchar *secondary_pipeline_cmd = g_strdup_printf(
       "appsrc name=appsrc_video "
       "max-buffers=1 leaky_type=2 format=3 "
       "caps=video/x-raw,width=%d,height=%d,framerate=30/1,format=YUY2 ! "
       "video/x-raw,width=%d,height=%d,framerate=30/1 ! "
-      "videocrop name=video_crop ! "
-      "%s ! video/x-raw,width=256,height=256 ! "
+      "%s"
+      "%s ! video/x-raw,width=%d,height=%d ! "
       "videoconvert ! video/x-raw,format=RGB ! "
       "tensor_converter ! "
       "tensor_transform mode=arithmetic "
       "option=typecast:float32,div:255.0 ! "
-      "tensor_filter framework=tensorflow-lite "
-      "model=%s "
-      "accelerator=true:npu "
-      "custom=Delegate:External,ExtDelegateLib:%s "
-      "name=tensor_filter_landmark ! "
-      "tensor_sink name=second_tensor_sink",
-      video_width, video_height, video_width, video_height, nxp_converter,
-      pose_landmark_model, delegate);
+      "%s",
+      video_width, video_height, video_width, video_height,
+      (data.crop_meta ? "" : "videocrop name=video_crop ! "), nxp_converter,
+      data.landmark_input_size, data.landmark_input_size, landmark_models);
+  g_free(landmark_models);
 
   // Parse main pipeline
+  phase = startup_trace.begin("pipelines construction");
   data.pipeline = gst_parse_launch(pipeline_cmd, NULL);
   g_free(pipeline_cmd);
 
   // Parse secondary pipeline
   data.secondary_pipeline = gst_parse_launch(secondary_pipeline_cmd, NULL);
   g_free(secondary_pipeline_cmd);
+  startup_trace.end(phase);
+
+  // Wait for the parallel startup phases
+  data.pose_detection_interpreter = detection_interpreter.get();
+  data.classifier = classifier.get();
+  g_print("Pose classifier: %s\n", data.classifier->get_backend_name());
+  PoseClassifier *knn_classifier =
+      (classifier_model == nullptr)
+          ? static_cast<PoseClassifier *>(data.classifier)
+          : nullptr;
+  if (knn_classifier != nullptr) {
+    g_print("Pose classifier threads: %zu\n",
+            knn_classifier->get_num_threads());
+    if (knn_classifier->get_precision() != QuantizedIndex::FLOAT) {
+      g_print("Pose classifier index: %s, %.1f KiB, %.1f%% of the results "
+              "match float\n",
+              QuantizedIndex::get_precision_name(
+                  knn_classifier->get_precision()),
+              knn_classifier->get_index_size_bytes() / 1024.0,
+              knn_classifier->get_index_agreement() * 100.0);
+    }
+  } else {
+    g_print("Pose classifier model: %zu multiply-accumulates per "
+            "orientation\n",
+            static_cast<MlpClassifier *>(data.classifier)
+                ->get_num_operations());
+  }
+
+  // Distances to the pose samples run through a third tensor_filter, with
+  // the delegate of the pose models
+  if (distance_model != nullptr && knn_classifier != nullptr) {
+    gchar *filter_options = g_strdup_printf(
+        "accelerator=true:npu custom=Delegate:External,ExtDelegateLib:%s",
+        delegate);
+    knn_classifier->set_distance_model(new DistanceModel(
+        distance_model, filter_options, knn_classifier->get_num_samples()));
+    g_free(filter_options);
+    g_print("Pose sample distances: %s\n",
+            knn_classifier->has_distance_model() ? distance_model : "CPU");
+  } else if (distance_model != nullptr) {
+    g_print("Distance model only applies to the k-NN classifier, "
+            "ignoring...\n");
+  }
+
+  // Exercises share a single classification pass
+  ExerciseRegistry registry = (exercises != nullptr)
+                                  ? ExerciseRegistry(exercises)
+                                  : ExerciseRegistry();
+  data.engine = new ExerciseEngine(data.classifier, registry);
+
+  // Classification runs off the tensor_sink streaming thread
+  data.classification_worker =
+      new ClassificationWorker(data.engine, data.filter_bbox);
+  data.classification_worker->set_thread_policy(data.thread_policy);
+  data.classification_worker->start();
+
+  // Metrics are always collected, serving and logging them is optional
+  data.metrics = new Metrics();
+  data.metrics_server = nullptr;
+  data.metrics_log_interval = metrics_log_interval;
+  data.metrics_log_elapsed = 0;
+  setup_metrics(&data);
+  if (metrics_address != nullptr) {
+    data.metrics_server = new MetricsServer(data.metrics);
+    if (!data.metrics_server->start(metrics_address))
+      return EXIT_FAILURE;
+    g_print("Serving metrics on %s\n", metrics_address);
+  }
+  data.metrics_source_id =
+      g_timeout_add_seconds(1, (GSourceFunc)update_metrics, &data);
+  data.events_source_id =
+      g_timeout_add(100, (GSourceFunc)handle_repetition_events, &data);
 
   /* SET UP PRIMARY PIPELINE ELEMENTS */
 
+  // Count the captured frames and the frames dropped by the leaky queues
+  GstElement *tee = gst_bin_get_by_name(GST_BIN(data.pipeline), "t");
+  GstPad *tee_pad = gst_element_get_static_pad(tee, "sink");
+  gst_pad_add_probe(tee_pad, GST_PAD_PROBE_TYPE_BUFFER, count_buffers_probe,
+                    data.app_metrics.frames_captured, NULL);
+  gst_object_unref(tee_pad);
+  gst_object_unref(tee);
+  for (size_t i{0}; i < 3; i++)
+    add_queue_probes(&data.app_metrics.queues[i], GST_BIN(data.pipeline));
+
+  // Frames above the inference rate are dropped before the detection queue
+  GstElement *queue_detection =
+      gst_bin_get_by_name(GST_BIN(data.pipeline), "queue_detection");
+  GstPad *queue_pad = gst_element_get_static_pad(queue_detection, "sink");
+  GstPad *tee_src_pad = gst_pad_get_peer(queue_pad);
+  gst_pad_add_probe(tee_src_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                    (GstPadProbeCallback)detection_rate_probe, &data, NULL);
+  gst_object_unref(tee_src_pad);
+  gst_object_unref(queue_pad);
+  gst_object_unref(queue_detection);
+
   // Add callback to tensor_sink for pose detection
   data.tensor_sink_detection =
       gst_bin_get_by_name(GST_BIN(data.pipeline), "tensor_sink");
@@ -493,15 +1280,18 @@ int main(int argc, char *argv[]) {
                    G_CALLBACK(new_pose_detection), &data);
   gst_object_unref(GST_OBJECT(data.tensor_sink_detection));
 
-  // Add callback to appsink for pose landmark
+  // Add callback to appsink for pose landmark. Callbacks are called
+  // directly from the streaming thread, without signal emission.
   data.appsink = gst_bin_get_by_name(GST_BIN(data.pipeline), "appsink");
-  g_object_set(G_OBJECT(data.appsink), "emit-signals", (gboolean)TRUE, "sync",
+  g_object_set(G_OBJECT(data.appsink), "emit-signals", (gboolean)FALSE, "sync",
                (gboolean)FALSE, "drop", (gboolean)TRUE, NULL);
-  g_signal_connect(GST_OBJECT(data.appsink), "new-sample",
-                   G_CALLBACK(appsink_new_sample), &data);
+  GstAppSinkCallbacks appsink_callbacks = {};
+  appsink_callbacks.new_sample = appsink_new_sample;
+  gst_app_sink_set_callbacks(GST_APP_SINK(data.appsink), &appsink_callbacks,
+                             &data, NULL);
   gst_object_unref(GST_OBJECT(data.appsink));
 
-  // Add callback to cairooverlay for drawing results to screen
+  // Add callback to overlaycomposition for drawing results to screen
   data.overlay = gst_bin_get_by_name(GST_BIN(data.pipeline), "overlay");
   g_signal_connect(GST_OBJECT(data.overlay), "draw", G_CALLBACK(draw_overlay),
                    &data);
@@ -517,10 +1307,15 @@ int main(int argc, char *argv[]) {
 
   // Get FPS from waylandsink
   data.wayland_sink = gst_bin_get_by_name(GST_BIN(data.pipeline), "fps_sink");
+  g_object_set(G_OBJECT(data.wayland_sink), "signal-fps-measurements",
+               (gboolean)TRUE, NULL);
+  g_signal_connect(GST_OBJECT(data.wayland_sink), "fps-measurements",
+                   G_CALLBACK(fps_measurements), &data);
   gst_object_unref(GST_OBJECT(data.wayland_sink));
 
   // Add bus for message handling of pipeline
   data.bus = gst_pipeline_get_bus(GST_PIPELINE(data.pipeline));
+  gst_bus_set_sync_handler(data.bus, bus_sync_handler, &data, NULL);
   gst_bus_add_signal_watch(data.bus);
   g_signal_connect(data.bus, "message", G_CALLBACK(bus_message_callback),
                    &data);
@@ -537,30 +1332,74 @@ int main(int argc, char *argv[]) {
                    G_CALLBACK(new_pose_landmarks), &data);
   gst_object_unref(GST_OBJECT(data.tensor_sink_landmark));
 
+  // Route every frame to the model chosen by the cascade, both tensor_sinks
+  // share the same callback
+  if (data.model_cascade != nullptr) {
+    data.landmark_selector = gst_bin_get_by_name(
+        GST_BIN(data.secondary_pipeline), "landmark_selector");
+    data.landmark_pads[ModelCascade::FAST] =
+        gst_element_get_static_pad(data.landmark_selector, "src_0");
+    data.landmark_pads[ModelCascade::ACCURATE] =
+        gst_element_get_static_pad(data.landmark_selector, "src_1");
+    g_object_set(G_OBJECT(data.landmark_selector), "active-pad",
+                 data.landmark_pads[data.landmark_model], NULL);
+    GstPad *selector_pad =
+        gst_element_get_static_pad(data.landmark_selector, "sink");
+    gst_pad_add_probe(selector_pad, GST_PAD_PROBE_TYPE_BUFFER,
+                      (GstPadProbeCallback)landmark_model_probe, &data, NULL);
+    gst_object_unref(selector_pad);
+    gst_object_unref(GST_OBJECT(data.landmark_selector));
+
+    data.tensor_sink_landmark_accurate = gst_bin_get_by_name(
+        GST_BIN(data.secondary_pipeline), "second_tensor_sink_accurate");
+    g_object_set(GST_OBJECT(data.tensor_sink_landmark_accurate), "emit-signal",
+                 (gboolean)TRUE, NULL);
+    g_signal_connect(GST_OBJECT(data.tensor_sink_landmark_accurate),
+                     "new-data", G_CALLBACK(new_pose_landmarks), &data);
+    gst_object_unref(GST_OBJECT(data.tensor_sink_landmark_accurate));
+
+    data.tensor_filter_landmark_accurate = gst_bin_get_by_name(
+        GST_BIN(data.secondary_pipeline), "tensor_filter_landmark_accurate");
+    g_object_set(data.tensor_filter_landmark_accurate, "latency", 1, NULL);
+    if (!landmark_combination[ModelCascade::ACCURATE].empty()) {
+      g_object_set(data.tensor_filter_landmark_accurate, "output-combination",
+                   landmark_combination[ModelCascade::ACCURATE].c_str(), NULL);
+    }
+    gst_object_unref(GST_OBJECT(data.tensor_filter_landmark_accurate));
+  }
+
   // Add callback to appsrc for pose landmark
   data.appsrc =
       gst_bin_get_by_name(GST_BIN(data.secondary_pipeline), "appsrc_video");
   g_object_set(G_OBJECT(data.appsrc), "is-live", (gboolean)TRUE, "stream-type",
                0, NULL);
-  g_signal_connect(GST_OBJECT(data.appsrc), "need-data", G_CALLBACK(start_feed),
-                   &data);
-  g_signal_connect(GST_OBJECT(data.appsrc), "enough-data",
-                   G_CALLBACK(stop_feed), &data);
+  GstAppSrcCallbacks appsrc_callbacks = {};
+  appsrc_callbacks.need_data = appsrc_need_data;
+  appsrc_callbacks.enough_data = appsrc_enough_data;
+  gst_app_src_set_callbacks(GST_APP_SRC(data.appsrc), &appsrc_callbacks, &data,
+                            NULL);
   gst_object_unref(GST_OBJECT(data.appsrc));
 
   // Videocrop for pose-landmarks
-  data.videocrop =
-      gst_bin_get_by_name(GST_BIN(data.secondary_pipeline), "video_crop");
-  gst_object_unref(GST_OBJECT(data.videocrop));
+  if (!data.crop_meta) {
+    data.videocrop =
+        gst_bin_get_by_name(GST_BIN(data.secondary_pipeline), "video_crop");
+    gst_object_unref(GST_OBJECT(data.videocrop));
+  }
 
   // Get latency property from pose_landmark
   data.tensor_filter_landmark = gst_bin_get_by_name(
       GST_BIN(data.secondary_pipeline), "tensor_filter_landmark");
   g_object_set(data.tensor_filter_landmark, "latency", 1, NULL);
+  if (!landmark_combination[ModelCascade::FAST].empty()) {
+    g_object_set(data.tensor_filter_landmark, "output-combination",
+                 landmark_combination[ModelCascade::FAST].c_str(), NULL);
+  }
   gst_object_unref(GST_OBJECT(data.tensor_filter_landmark));
 
   // Add bus for message handling of secondary pipeline
   data.bus = gst_pipeline_get_bus(GST_PIPELINE(data.secondary_pipeline));
+  gst_bus_set_sync_handler(data.bus, bus_sync_handler, &data, NULL);
   gst_bus_add_signal_watch(data.bus);
   g_signal_connect(data.bus, "message", G_CALLBACK(bus_message_callback),
                    &data);
@@ -576,6 +1415,9 @@ int main(int argc, char *argv[]) {
   g_print("Setting secondary pipeline to PLAYING...\n");
   gst_element_set_state(data.secondary_pipeline, GST_STATE_PLAYING);
 
+  startup_trace.mark("pipelines playing");
+  startup_trace.report();
+
   // Set pipeline to run main loop
   g_main_loop_run(data.main_loop);
 
@@ -599,6 +1441,12 @@ int main(int argc, char *argv[]) {
   g_print("Setting secondary pipeline to NULL...\n");
   gst_element_set_state(data.secondary_pipeline, GST_STATE_NULL);
 
+  for (size_t i{0}; i < 2; i++) {
+    if (data.landmark_pads[i] != nullptr)
+      gst_object_unref(data.landmark_pads[i]);
+    data.landmark_pads[i] = nullptr;
+  }
+
   gst_object_unref(data.pipeline);
   data.pipeline = nullptr;
   gst_object_unref(data.secondary_pipeline);
@@ -612,19 +1460,76 @@ int main(int argc, char *argv[]) {
 
   g_mutex_clear(&data.g_mutex);
 
+  g_source_remove(data.metrics_source_id);
+  data.metrics_source_id = 0;
+  g_source_remove(data.events_source_id);
+  data.events_source_id = 0;
+  delete data.metrics_server;
+  data.metrics_server = nullptr;
+
+  data.classification_worker->stop();
+  g_print("Classification frames: %" G_GUINT64_FORMAT " processed, "
+          "%" G_GUINT64_FORMAT " dropped, %" G_GUINT64_FORMAT " stale, "
+          "%" G_GUINT64_FORMAT " gated\n",
+          data.classification_worker->get_processed_frames(),
+          data.classification_worker->get_dropped_frames(),
+          data.classification_worker->get_stale_frames(),
+          data.classification_worker->get_gated_frames());
+  if (data.classification_worker->get_dropped_events() > 0) {
+    g_print("Repetition events dropped: %" G_GUINT64_FORMAT "\n",
+            data.classification_worker->get_dropped_events());
+  }
+  g_print("Overlay layers rasterized: %" G_GUINT64_FORMAT " info, "
+          "%" G_GUINT64_FORMAT " exercise, %" G_GUINT64_FORMAT " count, "
+          "%" G_GUINT64_FORMAT " pose\n",
+          data.hud_layer->get_rasterized(),
+          data.exercise_layer->get_rasterized(),
+          data.count_layer->get_rasterized(),
+          data.pose_layer->get_rasterized());
+  if (data.idle_monitor->is_enabled()) {
+    g_print("Idle mode: %" G_GUINT64_FORMAT " wake-ups on motion, last "
+            "wake-up latency %.1f ms\n",
+            data.idle_monitor->get_wakeups(),
+            data.idle_monitor->get_wake_latency());
+  }
+  data.thread_policy->report();
+
+  if (data.composition != nullptr)
+    gst_video_overlay_composition_unref(data.composition);
+  delete data.hud_layer;
+  delete data.exercise_layer;
+  delete data.count_layer;
+  delete data.pose_layer;
+  delete data.classification_worker;
   delete data.pose_detection_interpreter;
   delete data.pose_landmark_interpreter;
-  delete data.filter_classification;
+  delete data.pose_landmark_interpreter_accurate;
+  delete data.model_cascade;
   delete data.filter_bbox;
-  delete data.counter;
+  delete data.engine;
   delete data.classifier;
+  delete data.metrics;
+  delete data.rate_controller;
+  delete data.idle_monitor;
+  delete data.thread_policy;
 
   data.pose_detection_interpreter = nullptr;
   data.pose_landmark_interpreter = nullptr;
-  data.filter_classification = nullptr;
+  data.pose_landmark_interpreter_accurate = nullptr;
+  data.model_cascade = nullptr;
   data.filter_bbox = nullptr;
-  data.counter = nullptr;
+  data.engine = nullptr;
   data.classifier = nullptr;
+  data.classification_worker = nullptr;
+  data.composition = nullptr;
+  data.hud_layer = nullptr;
+  data.exercise_layer = nullptr;
+  data.count_layer = nullptr;
+  data.pose_layer = nullptr;
+  data.metrics = nullptr;
+  data.rate_controller = nullptr;
+  data.idle_monitor = nullptr;
+  data.thread_policy = nullptr;
 
   return EXIT_SUCCESS;
 }
@@ -683,6 +1588,8 @@ static void bus_message_callback(GstBus *bus, GstMessage *message,
     g_print("Format: [%d], processed: [%" G_GUINT64_FORMAT
             "], dropped: [%" G_GUINT64_FORMAT "]\n",
             format, processed, dropped);
+    data->app_metrics.qos_processed->set(processed);
+    data->app_metrics.qos_dropped->set(dropped);
     break;
   }
 
@@ -692,11 +1599,37 @@ static void bus_message_callback(GstBus *bus, GstMessage *message,
 }
 
 /**
- * Get the caps information that need cairooverlay
+ * Streaming threads post a stream-status message when they start and stop.
+ * The message is handled synchronously from the thread itself, so the policy
+ * of the stage owning the thread is applied in place.
+ */
+static GstBusSyncReply bus_sync_handler(GstBus *bus, GstMessage *message,
+                                        gpointer user_data) {
+  UNUSED(bus);
+  AppData *data = (AppData *)user_data;
+  if (GST_MESSAGE_TYPE(message) != GST_MESSAGE_STREAM_STATUS)
+    return GST_BUS_PASS;
+
+  GstStreamStatusType type;
+  GstElement *owner = nullptr;
+  gst_message_parse_stream_status(message, &type, &owner);
+  if (type == GST_STREAM_STATUS_TYPE_ENTER)
+    data->thread_policy->enter(GST_ELEMENT_NAME(owner));
+  else if (type == GST_STREAM_STATUS_TYPE_LEAVE)
+    data->thread_policy->leave();
+
+  return GST_BUS_PASS;
+}
+
+/**
+ * Get the caps information that need overlaycomposition
  */
 static void configure_overlay_callback(GstElement *overlay, GstCaps *caps,
+                                       guint window_width, guint window_height,
                                        AppData *data) {
   UNUSED(overlay);
+  UNUSED(window_width);
+  UNUSED(window_height);
   CairoOverlayState *state = &(data->overlay_state);
   state->valid = gst_video_info_from_caps(&state->vinfo, caps);
 }
@@ -706,71 +1639,553 @@ static void configure_overlay_callback(GstElement *overlay, GstCaps *caps,
  */
 static void new_pose_detection(GstElement *sink, GstBuffer *gstbuffer,
                                AppData *data) {
-  UNUSED(sink);
-  GstMemory *mem = NULL;
-  GstMapInfo info;
-
-  float *raw_scores = nullptr;
-  float *bbox_detection = nullptr;
-
-  for (size_t i{0}; i < gst_buffer_n_memory(gstbuffer); i++) {
-    g_mutex_lock(&data->g_mutex);
-    mem = gst_buffer_peek_memory(gstbuffer, i);
-    g_mutex_unlock(&data->g_mutex);
-    if (mem != NULL) {
-      if (gst_memory_map(mem, &info, GST_MAP_READ)) {
-        size_t length = info.size / 4;
-        if (length == 2254) {
-          raw_scores = (float *)(info.data);
-        }
-        if (length == 27048) {
-          bbox_detection = (float *)(info.data);
-        }
-        gst_memory_unmap(mem, &info);
-      }
-    } else {
-      g_printerr("Failed peek memory\n");
+  PoseDetectionInterpreter *interpreter = data->pose_detection_interpreter;
+
+  // Output tensors are known once the caps are negotiated
+  if (!interpreter->is_configured()) {
+    std::vector<TensorSpec> outputs;
+    if (!get_tensors_info(sink, outputs))
+      return;
+    if (!interpreter->configure(outputs, data->detection_input_size))
+      exit(-1);
+  }
+
+  size_t scores_index = interpreter->get_scores_index();
+  size_t boxes_index = interpreter->get_boxes_index();
+  if (std::max(scores_index, boxes_index) >= gst_buffer_n_memory(gstbuffer)) {
+    g_printerr("Missing pose detection tensors\n");
+    return;
+  }
+
+  g_mutex_lock(&data->g_mutex);
+  GstMemory *mem_scores = gst_buffer_peek_memory(gstbuffer, scores_index);
+  GstMemory *mem_boxes = gst_buffer_peek_memory(gstbuffer, boxes_index);
+  g_mutex_unlock(&data->g_mutex);
+
+  GstMapInfo info_scores;
+  GstMapInfo info_boxes;
+  if (!gst_memory_map(mem_scores, &info_scores, GST_MAP_READ)) {
+    g_printerr("Failed to map pose detection scores\n");
+    return;
+  }
+  if (!gst_memory_map(mem_boxes, &info_boxes, GST_MAP_READ)) {
+    g_printerr("Failed to map pose detection boxes\n");
+    gst_memory_unmap(mem_scores, &info_scores);
+    return;
+  }
+
+  // Detections are read by the overlay callback on the display thread
+  g_mutex_lock(&data->g_mutex);
+  interpreter->decode_predictions((float *)(info_boxes.data),
+                                  (float *)(info_scores.data));
+  bool pose_found = !interpreter->get_pose_detections().empty();
+  g_mutex_unlock(&data->g_mutex);
+  gst_memory_unmap(mem_boxes, &info_boxes);
+  gst_memory_unmap(mem_scores, &info_scores);
+  data->startup_trace->mark("first pose detection");
+
+  if (data->idle_monitor->update_detection(pose_found,
+                                           g_get_monotonic_time())) {
+    if (data->idle_monitor->is_idle())
+      g_print("Entering idle mode: no pose detected\n");
+    else
+      g_print("Leaving idle mode: pose detected\n");
+  }
+}
+
+/**
+ * Function to read the output tensors negotiated on a tensor_sink
+ */
+static bool get_tensors_info(GstElement *sink,
+                             std::vector<TensorSpec> &tensors) {
+  GstPad *pad = gst_element_get_static_pad(sink, "sink");
+  GstCaps *caps = gst_pad_get_current_caps(pad);
+  gst_object_unref(pad);
+  if (caps == NULL) {
+    g_printerr("Tensor caps not negotiated on %s\n", GST_ELEMENT_NAME(sink));
+    return false;
+  }
+
+  bool valid = get_tensor_specs(caps, tensors);
+  gst_caps_unref(caps);
+  if (!valid)
+    g_printerr("Invalid tensor caps on %s\n", GST_ELEMENT_NAME(sink));
+  return valid;
+}
+
+/**
+ * Function to run a dummy inference on a model before the camera goes live
+ */
+static void warm_up_model(const gchar *model, const gchar *delegate,
+                          const int &input_size, const gchar *transform,
+                          std::vector<TensorSpec> &outputs) {
+  gchar *warmup_cmd = g_strdup_printf(
+      "videotestsrc num-buffers=1 pattern=black ! "
+      "video/x-raw,width=%d,height=%d,format=RGB ! "
+      "tensor_converter ! "
+      "tensor_transform mode=arithmetic option=%s ! "
+      "tensor_filter framework=tensorflow-lite "
+      "model=%s "
+      "accelerator=true:npu "
+      "custom=Delegate:External,ExtDelegateLib:%s ! "
+      "tensor_sink name=warmup_sink",
+      input_size, input_size, transform, model, delegate);
+
+  GstElement *pipeline = gst_parse_launch(warmup_cmd, NULL);
+  g_free(warmup_cmd);
+  if (!pipeline) {
+    g_printerr("Failed to create warm-up pipeline for %s\n", model);
+    return;
+  }
+
+  // Wait for the single buffer to go through the model
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+  GstBus *bus = gst_element_get_bus(pipeline);
+  GstMessage *msg = gst_bus_timed_pop_filtered(
+      bus, GST_CLOCK_TIME_NONE,
+      (GstMessageType)(GST_MESSAGE_ERROR | GST_MESSAGE_EOS));
+  if (msg != NULL) {
+    if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR)
+      g_printerr("Warm-up of %s failed\n", model);
+    gst_message_unref(msg);
+  }
+  gst_object_unref(bus);
+
+  // Output tensors of the model, negotiated by the single buffer
+  outputs.clear();
+  GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), "warmup_sink");
+  if (!get_tensors_info(sink, outputs))
+    outputs.clear();
+  gst_object_unref(sink);
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+}
+
+/**
+ * Function to register the metrics of the application
+ */
+static void setup_metrics(AppData *data) {
+  Metrics *metrics = data->metrics;
+  AppMetrics *app_metrics = &data->app_metrics;
+
+  app_metrics->frames_captured = metrics->add_counter(
+      "imx_fitness_frames_captured_total", "Frames captured by the camera");
+
+  const char *queue_names[3] = {"queue_detection", "queue_landmark",
+                                "queue_display"};
+  for (size_t i{0}; i < 3; i++) {
+    app_metrics->queues[i].name = queue_names[i];
+    app_metrics->queues[i].queue = nullptr;
+  }
+  for (size_t i{0}; i < 3; i++) {
+    app_metrics->queues[i].dropped_frames = metrics->add_counter(
+        "imx_fitness_queue_dropped_frames_total",
+        "Frames dropped by a leaky queue",
+        std::string("queue=\"") + queue_names[i] + "\"");
+  }
+  for (size_t i{0}; i < 3; i++) {
+    app_metrics->queues[i].input_frames = metrics->add_counter(
+        "imx_fitness_queue_input_frames_total", "Frames entering a queue",
+        std::string("queue=\"") + queue_names[i] + "\"");
+  }
+  for (size_t i{0}; i < 3; i++) {
+    app_metrics->queues[i].output_frames = metrics->add_counter(
+        "imx_fitness_queue_output_frames_total", "Frames leaving a queue",
+        std::string("queue=\"") + queue_names[i] + "\"");
+  }
+
+  app_metrics->qos_processed = metrics->add_gauge(
+      "imx_fitness_qos_processed_frames",
+      "Frames processed reported by the latest QoS message");
+  app_metrics->qos_dropped = metrics->add_gauge(
+      "imx_fitness_qos_dropped_frames",
+      "Frames dropped reported by the latest QoS message");
+
+  app_metrics->display_fps = metrics->add_gauge(
+      "imx_fitness_display_fps", "Current frame rate of the display");
+  app_metrics->display_average_fps = metrics->add_gauge(
+      "imx_fitness_display_average_fps", "Average frame rate of the display");
+  app_metrics->display_drop_rate = metrics->add_gauge(
+      "imx_fitness_display_drop_rate",
+      "Frames dropped per second by the display sink");
+
+  app_metrics->detection_latency = metrics->add_gauge(
+      "imx_fitness_detection_latency_ms",
+      "Average pose detection inference time");
+  app_metrics->landmark_latency = metrics->add_gauge(
+      "imx_fitness_landmark_latency_ms",
+      "Average pose landmark inference time");
+  app_metrics->landmark_pruned_bytes = metrics->add_gauge(
+      "imx_fitness_landmark_pruned_bytes",
+      "Bytes per frame of pose landmark outputs not pushed downstream");
+  app_metrics->landmark_accurate_latency = nullptr;
+  app_metrics->landmark_model_frames[0] = nullptr;
+  app_metrics->landmark_model_frames[1] = nullptr;
+  if (data->model_cascade != nullptr) {
+    app_metrics->landmark_accurate_latency = metrics->add_gauge(
+        "imx_fitness_landmark_accurate_latency_ms",
+        "Average accurate pose landmark inference time");
+    const char *model_names[2] = {"fast", "accurate"};
+    for (size_t i{0}; i < 2; i++) {
+      app_metrics->landmark_model_frames[i] = metrics->add_counter(
+          "imx_fitness_landmark_model_frames_total",
+          "Frames run through each landmark model of the cascade",
+          std::string("model=\"") + model_names[i] + "\"");
+    }
+  }
+  app_metrics->classification_latency = metrics->add_gauge(
+      "imx_fitness_classification_latency_ms",
+      "Time from landmark decoding to classification result");
+  app_metrics->classification_dropped = metrics->add_counter(
+      "imx_fitness_classification_dropped_frames_total",
+      "Landmarks dropped because the classification queue was full");
+  app_metrics->classification_stale = metrics->add_counter(
+      "imx_fitness_classification_stale_frames_total",
+      "Landmarks skipped by the classification worker");
+  app_metrics->classification_gated = metrics->add_counter(
+      "imx_fitness_classification_gated_frames_total",
+      "Landmarks without the visible keypoints of the active exercise");
+
+  app_metrics->frames_analyzed = metrics->add_counter(
+      "imx_fitness_frames_analyzed_total",
+      "Frames checked for a person by the landmark branch");
+  app_metrics->frames_person_present = metrics->add_counter(
+      "imx_fitness_frames_person_present_total",
+      "Frames with a person in the field of view");
+  app_metrics->person_present_ratio = metrics->add_gauge(
+      "imx_fitness_person_present_ratio",
+      "Ratio of frames with a person since the previous update");
+  app_metrics->last_frames_analyzed = 0;
+  app_metrics->last_frames_person_present = 0;
+
+  app_metrics->inference_rate = metrics->add_gauge(
+      "imx_fitness_inference_rate_hz",
+      "Rate of the pose detection and landmark inferences");
+  app_metrics->inference_rate_changes = metrics->add_counter(
+      "imx_fitness_inference_rate_changes_total",
+      "Changes of the inference rate");
+  app_metrics->inference_rate->set(data->rate_controller->get_rate());
+  app_metrics->idle = metrics->add_gauge(
+      "imx_fitness_idle", "1 while in the low-power idle mode, 0 otherwise");
+  app_metrics->idle_wakeups = metrics->add_counter(
+      "imx_fitness_idle_wakeups_total", "Idle mode exits on motion");
+  app_metrics->wake_latency = metrics->add_gauge(
+      "imx_fitness_wake_latency_ms",
+      "Time from the motion that left the idle mode to the detected pose");
+  app_metrics->last_qos_processed = 0;
+  app_metrics->last_qos_dropped = 0;
+  app_metrics->last_detection_input = 0;
+  app_metrics->last_detection_dropped = 0;
+
+  app_metrics->landmark_interval = metrics->add_gauge(
+      "imx_fitness_landmark_interval_ms",
+      "Smoothed interval between pose landmark results");
+  app_metrics->landmark_jitter = metrics->add_gauge(
+      "imx_fitness_landmark_jitter_ms",
+      "Smoothed deviation of the interval between pose landmark results");
+  app_metrics->last_landmark_time = 0;
+  app_metrics->landmark_interval_mean = 0;
+  app_metrics->landmark_interval_jitter = 0;
+  app_metrics->landmark_skipped = metrics->add_counter(
+      "imx_fitness_landmark_skipped_frames_total",
+      "Frames with a pose not pushed while the landmark branch was busy");
+
+  app_metrics->main_thread_cpu = metrics->add_gauge(
+      "imx_fitness_main_thread_cpu_ratio",
+      "CPU time of the main loop thread per second");
+  app_metrics->last_main_thread_cpu = 0;
+  app_metrics->last_main_thread_time = 0;
+
+  app_metrics->repetitions.clear();
+  for (size_t i{0}; i < data->engine->size(); i++) {
+    app_metrics->repetitions.push_back(metrics->add_gauge(
+        "imx_fitness_repetitions", "Repetitions of the current set",
+        "exercise=\"" + data->engine->get_exercise(i).name + "\""));
+  }
+}
+
+/**
+ * Function to count the buffers going through a pad
+ */
+static GstPadProbeReturn count_buffers_probe(GstPad *pad,
+                                             GstPadProbeInfo *info,
+                                             gpointer user_data) {
+  UNUSED(pad);
+  UNUSED(info);
+  static_cast<Metrics::Metric *>(user_data)->increment();
+  return GST_PAD_PROBE_OK;
+}
+
+/**
+ * Function to add the counting probes on both sides of a leaky queue
+ */
+static void add_queue_probes(QueueMetrics *queue_metrics, GstBin *bin) {
+  queue_metrics->queue = gst_bin_get_by_name(bin, queue_metrics->name);
+
+  GstPad *pad = gst_element_get_static_pad(queue_metrics->queue, "sink");
+  gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, count_buffers_probe,
+                    queue_metrics->input_frames, NULL);
+  gst_object_unref(pad);
+
+  pad = gst_element_get_static_pad(queue_metrics->queue, "src");
+  gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, count_buffers_probe,
+                    queue_metrics->output_frames, NULL);
+  gst_object_unref(pad);
+
+  gst_object_unref(GST_OBJECT(queue_metrics->queue));
+}
+
+/**
+ * Function to handle fpsdisplaysink callback for FPS measurements
+ */
+static void fps_measurements(GstElement *fps_sink, gdouble fps,
+                             gdouble drop_rate, gdouble average_fps,
+                             AppData *data) {
+  UNUSED(fps_sink);
+  data->app_metrics.display_fps->set(fps);
+  data->app_metrics.display_average_fps->set(average_fps);
+  data->app_metrics.display_drop_rate->set(drop_rate);
+}
+
+/**
+ * Function to update the polled metrics and print the JSON log
+ */
+static gboolean update_metrics(AppData *data) {
+  AppMetrics *app_metrics = &data->app_metrics;
+
+  // Buffers neither forwarded nor queued were dropped
+  for (size_t i{0}; i < 3; i++) {
+    QueueMetrics *queue_metrics = &app_metrics->queues[i];
+    guint level = 0;
+    g_object_get(G_OBJECT(queue_metrics->queue), "current-level-buffers",
+                 &level, NULL);
+    double dropped = queue_metrics->input_frames->get() -
+                     queue_metrics->output_frames->get() - level;
+    queue_metrics->dropped_frames->set(std::max(0.0, dropped));
+  }
+
+  app_metrics->idle->set(data->idle_monitor->is_idle() ? 1 : 0);
+  app_metrics->idle_wakeups->set(data->idle_monitor->get_wakeups());
+  app_metrics->wake_latency->set(data->idle_monitor->get_wake_latency());
+
+  guint latency = 0;
+  g_object_get(G_OBJECT(data->tensor_filter_pose), "latency", &latency, NULL);
+  app_metrics->detection_latency->set(latency / 1000.0);
+  g_object_get(G_OBJECT(data->tensor_filter_landmark), "latency", &latency,
+               NULL);
+  app_metrics->landmark_latency->set(latency / 1000.0);
+  app_metrics->landmark_pruned_bytes->set(
+      data->landmark_pruned_bytes[data->landmark_model]);
+
+  // The accurate landmark model runs only when it fits in the frame period
+  // next to the pose detection
+  if (data->model_cascade != nullptr) {
+    g_object_get(G_OBJECT(data->tensor_filter_landmark_accurate), "latency",
+                 &latency, NULL);
+    app_metrics->landmark_accurate_latency->set(latency / 1000.0);
+    data->model_cascade->update_budget(
+        app_metrics->landmark_accurate_latency->get(),
+        app_metrics->detection_latency->get(),
+        1000.0 / data->rate_controller->get_rate());
+  }
+
+  app_metrics->classification_dropped->set(
+      data->classification_worker->get_dropped_frames());
+  app_metrics->classification_stale->set(
+      data->classification_worker->get_stale_frames());
+  app_metrics->classification_gated->set(
+      data->classification_worker->get_gated_frames());
+
+  double analyzed = app_metrics->frames_analyzed->get();
+  double person_present = app_metrics->frames_person_present->get();
+  if (analyzed > app_metrics->last_frames_analyzed) {
+    app_metrics->person_present_ratio->set(
+        (person_present - app_metrics->last_frames_person_present) /
+        (analyzed - app_metrics->last_frames_analyzed));
+  }
+  app_metrics->last_frames_analyzed = analyzed;
+  app_metrics->last_frames_person_present = person_present;
+
+  // CPU time of this thread, which runs the GLib main loop
+  struct timespec cpu_time;
+  struct timespec wall_time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time);
+  clock_gettime(CLOCK_MONOTONIC, &wall_time);
+  double cpu = cpu_time.tv_sec + cpu_time.tv_nsec / 1e9;
+  double wall = wall_time.tv_sec + wall_time.tv_nsec / 1e9;
+  if (app_metrics->last_main_thread_time > 0) {
+    app_metrics->main_thread_cpu->set(
+        (cpu - app_metrics->last_main_thread_cpu) /
+        (wall - app_metrics->last_main_thread_time));
+  }
+  app_metrics->last_main_thread_cpu = cpu;
+  app_metrics->last_main_thread_time = wall;
+
+  update_inference_rate(data);
+
+  if (data->metrics_log_interval > 0 &&
+      ++data->metrics_log_elapsed >= data->metrics_log_interval) {
+    data->metrics_log_elapsed = 0;
+    g_print("%s\n", data->metrics->to_json().c_str());
+  }
+  return TRUE;
+}
+
+/**
+ * Function to handle the repetition events of the classification worker
+ */
+static gboolean handle_repetition_events(AppData *data) {
+  RepetitionEvent event;
+  while (data->classification_worker->pop_event(event)) {
+    const Exercise &exercise = data->engine->get_exercise(event.exercise);
+    data->app_metrics.repetitions.at(event.exercise)->set(event.repetitions);
+    if (event.repetitions > 0)
+      data->startup_trace->mark("first counted repetition");
+    g_print("%s: %d repetitions (%.3f s)\n", exercise.name.c_str(),
+            event.repetitions, event.timestamp / 1e6);
+  }
+  return TRUE;
+}
+
+/**
+ * Function to update the inference rate from the latest metrics
+ */
+static void update_inference_rate(AppData *data) {
+  AppMetrics *app_metrics = &data->app_metrics;
+
+  // Frames dropped by the display sink or the detection queue since the
+  // previous update
+  double qos_processed = app_metrics->qos_processed->get();
+  double qos_dropped = app_metrics->qos_dropped->get();
+  double qos_frames = (qos_processed - app_metrics->last_qos_processed) +
+                      (qos_dropped - app_metrics->last_qos_dropped);
+  double drop_ratio = 0.0;
+  if (qos_frames > 0) {
+    drop_ratio = (qos_dropped - app_metrics->last_qos_dropped) / qos_frames;
+  }
+
+  QueueMetrics *detection = &app_metrics->queues[0];
+  double detection_input = detection->input_frames->get();
+  double detection_dropped = detection->dropped_frames->get();
+  if (detection_input > app_metrics->last_detection_input) {
+    drop_ratio = std::max(
+        drop_ratio, (detection_dropped - app_metrics->last_detection_dropped) /
+                        (detection_input - app_metrics->last_detection_input));
+  }
+
+  app_metrics->last_qos_processed = qos_processed;
+  app_metrics->last_qos_dropped = qos_dropped;
+  app_metrics->last_detection_input = detection_input;
+  app_metrics->last_detection_dropped = detection_dropped;
+
+  // Both models share the NPU for every processed frame
+  float inference_time = app_metrics->detection_latency->get() +
+                         app_metrics->landmark_latency->get();
+  float latency =
+      inference_time + app_metrics->classification_latency->get();
+
+  if (data->rate_controller->update(inference_time, latency, drop_ratio)) {
+    g_print("Inference rate set to %.0f Hz: %s\n",
+            data->rate_controller->get_rate(),
+            data->rate_controller->get_reason().c_str());
+    app_metrics->inference_rate->set(data->rate_controller->get_rate());
+    app_metrics->inference_rate_changes->increment();
+  }
+}
+
+/**
+ * Function to skip the pose detection of frames above the inference rate
+ */
+static GstPadProbeReturn detection_rate_probe(GstPad *pad,
+                                              GstPadProbeInfo *info,
+                                              AppData *data) {
+  UNUSED(pad);
+
+  // While idle, only frames with motion and the low rate frames are analyzed
+  if (data->idle_monitor->is_idle()) {
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    GstVideoMeta *meta = gst_buffer_get_video_meta(buffer);
+    int stride = (meta != NULL) ? meta->stride[0] : WIDTH * 2;
+    GstMapInfo map;
+    bool admitted = false;
+    if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+      admitted = data->idle_monitor->admit_frame(
+          map.data, WIDTH, HEIGHT, stride, g_get_monotonic_time());
+      gst_buffer_unmap(buffer, &map);
     }
+    if (!data->idle_monitor->is_idle())
+      g_print("Leaving idle mode: motion detected\n");
+    return admitted ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
   }
 
-  data->pose_detection_interpreter->decode_predictions(bbox_detection,
-                                                       raw_scores);
+  if (data->rate_controller->admit_detection())
+    return GST_PAD_PROBE_OK;
+  return GST_PAD_PROBE_DROP;
 }
 
 /**
  * Function to handle appsink callback for pose landmarks
  */
-static GstFlowReturn appsink_new_sample(GstElement *appsink, AppData *data) {
+static GstFlowReturn appsink_new_sample(GstAppSink *appsink,
+                                        gpointer user_data) {
+  AppData *data = static_cast<AppData *>(user_data);
   GstSample *sample;
   GstBuffer *buffer;
-  GstFlowReturn ret;
 
   // Get sample from appsink
-  sample = gst_app_sink_pull_sample(GST_APP_SINK(appsink));
+  sample = gst_app_sink_pull_sample(appsink);
   buffer = gst_sample_get_buffer(sample);
   if (!buffer) {
     g_printerr("Got NULL buffer from sample! Exiting...\n");
     return GST_FLOW_EOS;
   }
 
+  // Frames above the inference rate or while idle are not analyzed
+  if (data->idle_monitor->is_idle() ||
+      !data->rate_controller->admit_landmark()) {
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+  }
+
+  data->app_metrics.frames_analyzed->increment();
   if (data->left > 0 && data->top > 0 && data->pose("xmax") < WIDTH &&
       data->pose("ymax") < HEIGHT) {
     if (data->roi_width_bbox > 0 && data->left + data->roi_width_bbox < WIDTH &&
         data->roi_height_bbox > 0 &&
         data->top + data->roi_height_bbox < HEIGHT) {
-      // Update size for cropping bbox for pose detection
-      g_mutex_lock(&data->g_mutex);
-      g_object_set(G_OBJECT(data->videocrop), "left", data->left, "right",
-                   data->right, "top", data->top, "bottom", data->bottom, NULL);
-      g_signal_emit_by_name(data->appsrc, "push-buffer", buffer, &ret);
-      g_mutex_unlock(&data->g_mutex);
+      if (!data->appsrc_ready) {
+        // Secondary pipeline is still busy with the previous pose
+        data->app_metrics.landmark_skipped->increment();
+      } else if (data->crop_meta) {
+        // Crop travels with the buffer. The copy shares the frame memory.
+        guint left = data->left;
+        guint top = data->top;
+        GstBuffer *roi_buffer = gst_buffer_copy(buffer);
+        GstVideoCropMeta *crop = gst_buffer_add_video_crop_meta(roi_buffer);
+        crop->x = left;
+        crop->y = top;
+        crop->width = WIDTH - left - data->right;
+        crop->height = HEIGHT - top - data->bottom;
+        gst_app_src_push_buffer(GST_APP_SRC(data->appsrc), roi_buffer);
+      } else {
+        // Update size for cropping bbox for pose detection
+        g_mutex_lock(&data->g_mutex);
+        g_object_set(G_OBJECT(data->videocrop), "left", data->left, "right",
+                     data->right, "top", data->top, "bottom", data->bottom,
+                     NULL);
+        gst_app_src_push_buffer(GST_APP_SRC(data->appsrc),
+                                gst_buffer_ref(buffer));
+        g_mutex_unlock(&data->g_mutex);
+      }
       data->pose_detected = true;
+      data->app_metrics.frames_person_present->increment();
     }
   } else {
     data->pose_detected = false;
-    // No landmark will be detected; add empty result
-    ClassificationResult empty;
-    data->result = data->filter_classification->filter(empty);
+    // No landmark will be detected; add empty result. Landmarks are submitted
+    // by the secondary pipeline thread, so this goes through the atomic path.
+    data->classification_worker->submit_no_pose();
   }
 
   gst_sample_unref(sample);
@@ -778,163 +2193,357 @@ static GstFlowReturn appsink_new_sample(GstElement *appsink, AppData *data) {
 }
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to handle appsrc callback when it needs data
  */
-static void start_feed(GstElement *appsrc, guint size, AppData *data) {
+static void appsrc_need_data(GstAppSrc *appsrc, guint size,
+                             gpointer user_data) {
   UNUSED(appsrc);
   UNUSED(size);
-  if (data->source_id == 0) {
-    g_print("Start feeding frames to secondary pipeline...\n");
-    data->source_id = g_idle_add((GSourceFunc)push_data, data);
-  }
+  static_cast<AppData *>(user_data)->appsrc_ready = true;
+}
+
+/**
+ * Function to handle appsrc callback when its queue is full
+ */
+static void appsrc_enough_data(GstAppSrc *appsrc, gpointer user_data) {
+  UNUSED(appsrc);
+  static_cast<AppData *>(user_data)->appsrc_ready = false;
 }
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to handle tensor_sink callback for pose landmarks
  */
-static void stop_feed(GstElement *source, AppData *data) {
-  UNUSED(source);
-  if (data->source_id != 0) {
-    g_print("Stop feeding...\n");
-    g_source_remove(data->source_id);
-    data->source_id = 0;
+static void new_pose_landmarks(GstElement *sink, GstBuffer *gstbuffer,
+                               AppData *data) {
+  PoseLandmarkInterpreter *interpreter =
+      (sink == data->tensor_sink_landmark_accurate)
+          ? data->pose_landmark_interpreter_accurate
+          : data->pose_landmark_interpreter;
+
+  // Output tensors are known once the caps are negotiated
+  if (!interpreter->is_configured()) {
+    std::vector<TensorSpec> outputs;
+    if (!get_tensors_info(sink, outputs))
+      return;
+    if (!interpreter->configure(outputs, data->landmark_input_size))
+      exit(-1);
+  }
+
+  size_t landmarks_index = interpreter->get_landmarks_index();
+  size_t score_index = interpreter->get_score_index();
+  if (std::max(landmarks_index, score_index) >=
+      gst_buffer_n_memory(gstbuffer)) {
+    g_printerr("Missing pose landmark tensors\n");
+    return;
+  }
+
+  g_mutex_lock(&data->g_mutex);
+  GstMemory *mem_landmarks = gst_buffer_peek_memory(gstbuffer, landmarks_index);
+  GstMemory *mem_score = gst_buffer_peek_memory(gstbuffer, score_index);
+  g_mutex_unlock(&data->g_mutex);
+
+  GstMapInfo info_landmarks;
+  GstMapInfo info_score;
+  if (!gst_memory_map(mem_landmarks, &info_landmarks, GST_MAP_READ)) {
+    g_printerr("Failed to map pose landmarks\n");
+    return;
+  }
+  if (!gst_memory_map(mem_score, &info_score, GST_MAP_READ)) {
+    g_printerr("Failed to map pose landmark score\n");
+    gst_memory_unmap(mem_landmarks, &info_landmarks);
+    return;
+  }
+
+  float score = *(float *)(info_score.data);
+  bool decoded =
+      interpreter->decode_predictions((float *)(info_landmarks.data), score);
+  gst_memory_unmap(mem_score, &info_score);
+  gst_memory_unmap(mem_landmarks, &info_landmarks);
+  Landmark landmark = interpreter->get_pose_landmark();
+
+  // Choose the landmark model of the next frame
+  if (data->model_cascade != nullptr) {
+    ClassificationFrame latest = data->classification_worker->get_latest();
+    data->model_cascade->update_frame(landmark, score, decoded,
+                                      get_class_margin(latest.result));
+  }
+
+  // Frame time jitter, gaps without pose are ignored
+  AppMetrics *app_metrics = &data->app_metrics;
+  gint64 now = g_get_monotonic_time();
+  double interval = (now - app_metrics->last_landmark_time) / 1000.0;
+  if (app_metrics->last_landmark_time > 0 && interval < 1000.0) {
+    app_metrics->landmark_interval_mean +=
+        0.05 * (interval - app_metrics->landmark_interval_mean);
+    app_metrics->landmark_interval_jitter +=
+        0.05 * (std::abs(interval - app_metrics->landmark_interval_mean) -
+                app_metrics->landmark_interval_jitter);
+    app_metrics->landmark_interval->set(app_metrics->landmark_interval_mean);
+    app_metrics->landmark_jitter->set(app_metrics->landmark_interval_jitter);
   }
+  app_metrics->last_landmark_time = now;
+
+  // Filtering and classification are done by the classification worker,
+  // landmarks below the score threshold are handled as frames without pose
+  data->classification_worker->submit(landmark, decoded);
+  data->startup_trace->mark("first pose landmark");
 }
 
 /**
- * Function to handle appsrc callback for pose landmarks
+ * Function to route each frame to the landmark model chosen by the cascade
  */
-static gboolean push_data(AppData *data) {
-  UNUSED(data);
-  return TRUE;
+static GstPadProbeReturn landmark_model_probe(GstPad *pad,
+                                              GstPadProbeInfo *info,
+                                              AppData *data) {
+  UNUSED(pad);
+  UNUSED(info);
+  ModelCascade::Model model = data->model_cascade->get_model();
+  if (model != data->landmark_model) {
+    g_object_set(G_OBJECT(data->landmark_selector), "active-pad",
+                 data->landmark_pads[model], NULL);
+    data->landmark_model = model;
+  }
+  data->app_metrics.landmark_model_frames[model]->increment();
+  return GST_PAD_PROBE_OK;
 }
 
 /**
- * Function to handle tensor_sink callback for pose landmarks
+ * Function to compute the margin between the two most confident classes
  */
-static void new_pose_landmarks(GstElement *sink, GstBuffer *gstbuffer,
-                               AppData *data) {
-  UNUSED(sink);
-  GstMemory *mem = NULL;
-  GstMapInfo info;
-
-  float *score = nullptr;
-  float *raw_landmark = nullptr;
-
-  for (size_t i{0}; i < gst_buffer_n_memory(gstbuffer); i++) {
-    g_mutex_lock(&data->g_mutex);
-    mem = gst_buffer_peek_memory(gstbuffer, i);
-    g_mutex_unlock(&data->g_mutex);
-    if (mem != NULL) {
-      if (gst_memory_map(mem, &info, GST_MAP_READ)) {
-        size_t length = info.size / 4;
-        if (length == 195) {
-          raw_landmark = (float *)(info.data);
-        }
-        if (length == 1) {
-          score = (float *)(info.data);
-        }
-        gst_memory_unmap(mem, &info);
-      }
-    } else {
-      g_printerr("Failed peek memory\n");
+static float get_class_margin(const ClassificationResult &result) {
+  float first = 0.0;
+  float second = 0.0;
+  for (size_t i{0}; i < ClassificationResult::MAX_CLASSES; i++) {
+    float confidence = result.get_class_confidence(i);
+    if (confidence > first) {
+      second = first;
+      first = confidence;
+    } else if (confidence > second) {
+      second = confidence;
     }
   }
-
-  data->pose_landmark_interpreter->decode_predictions(raw_landmark, *score);
-  data->landmark = data->pose_landmark_interpreter->get_pose_landmark();
-  data->landmark = data->filter_bbox->filter(data->landmark);
-
-  ClassificationResult classification_result =
-      data->classifier->classify_pose(data->landmark);
-  data->result = data->filter_classification->filter(classification_result);
+  // Relative to the top confidence, 1 when no class is recognized
+  return (first > 0) ? (first - second) / first : 1.0;
 }
 
 /**
- * Function to handle cairooverlay callback to draw results
+ * Function to handle overlaycomposition callback to draw results
  */
-static void draw_overlay(GstElement *overlay, cairo_t *cr, guint64 timestamp,
-                         guint64 duration, AppData *data) {
+static GstVideoOverlayComposition *
+draw_overlay(GstElement *overlay, GstSample *sample, AppData *data) {
   UNUSED(overlay);
-  UNUSED(timestamp);
-  UNUSED(duration);
+  UNUSED(sample);
   CairoOverlayState *state = &(data->overlay_state);
 
-  if (state->valid == TRUE) {
-    // Set Cairo config
-    cairo_set_line_width(cr, 3);
+  if (state->valid != TRUE)
+    return NULL;
+
+  data->startup_trace->mark("first frame displayed");
+  bool changed = false;
+  char key[256];
+  std::string contents;
+
+  // Get pose detection inference time in us
+  g_object_get(G_OBJECT(data->tensor_filter_pose), "latency",
+               &data->inference_time_pose, NULL);
+
+  // Get pose landmark inference time in us, of the model in use
+  bool accurate = (data->landmark_model == ModelCascade::ACCURATE);
+  g_object_get(G_OBJECT(accurate ? data->tensor_filter_landmark_accurate
+                                 : data->tensor_filter_landmark),
+               "latency", &data->inference_time_landmark, NULL);
+
+  // Runtime strings, rasterized again only when one of them changes
+  char runtime_str[4][256];
+  snprintf(runtime_str[0], sizeof(runtime_str[0]),
+           "FRAME INFO: current: %.2f, average: %.2f, drop rate: %.2f",
+           data->app_metrics.display_fps->get(),
+           data->app_metrics.display_average_fps->get(),
+           data->app_metrics.display_drop_rate->get());
+  snprintf(runtime_str[1], sizeof(runtime_str[1]),
+           "Pose detection avg. inference time: %.2f ms",
+           data->inference_time_pose / 1000.0);
+  snprintf(runtime_str[2], sizeof(runtime_str[2]),
+           "Pose landmark avg. inference time: %.2f ms%s",
+           (data->pose_detected ? (data->inference_time_landmark / 1000.0)
+                                : 0.00),
+           (data->model_cascade == nullptr
+                ? ""
+                : (accurate ? " (accurate)" : " (fast)")));
+  if (data->idle_monitor->is_idle()) {
+    snprintf(runtime_str[3], sizeof(runtime_str[3]),
+             "Inference rate: %.0f Hz (idle)",
+             data->idle_monitor->get_idle_rate());
+  } else {
+    snprintf(runtime_str[3], sizeof(runtime_str[3]),
+             "Inference rate: %.0f Hz (%s)", data->rate_controller->get_rate(),
+             (data->rate_controller->is_adaptive() ? "auto" : "fixed"));
+  }
+
+  contents.clear();
+  for (size_t i{0}; i < 4; i++)
+    contents.append(runtime_str[i]).append("\n");
+  if (data->hud_layer->is_stale(contents)) {
+    cairo_t *cr =
+        data->hud_layer->begin(contents, 0, 0, HUD_WIDTH, HUD_HEIGHT);
     cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL,
                            CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, FONT_SIZE_LABEL_SCORE);
 
-    // Draw runtime string
-    char runtime_str[256];
-
-    gchar *fps_msg = nullptr;
-    g_object_get(G_OBJECT(data->wayland_sink), "last-message", &fps_msg, NULL);
-
-    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-    cairo_move_to(cr, 10, INIT_POSITION_RUNTIME_STR);
-    snprintf(runtime_str, sizeof(runtime_str), "FRAME INFO: %s", fps_msg);
-    cairo_show_text(cr, runtime_str);
-
-    // Get pose detection inference time in us
-    g_object_get(G_OBJECT(data->tensor_filter_pose), "latency",
-                 &data->inference_time_pose, NULL);
+    // Frame info in black, inference info in red
+    for (size_t i{0}; i < 4; i++) {
+      if (i == 0)
+        cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+      else
+        cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+      cairo_move_to(cr, 10, INIT_POSITION_RUNTIME_STR + 10 * i);
+      cairo_show_text(cr, runtime_str[i]);
+    }
+    data->hud_layer->end(cr);
+    changed = true;
+  }
 
-    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-    cairo_move_to(cr, 10, INIT_POSITION_RUNTIME_STR + 10);
-    snprintf(runtime_str, sizeof(runtime_str),
-             "Pose detection avg. inference time: %.2f ms",
-             data->inference_time_pose / 1000.0);
-    cairo_show_text(cr, runtime_str);
-
-    // Get pose landmark inference time in us
-    g_object_get(G_OBJECT(data->tensor_filter_landmark), "latency",
-                 &data->inference_time_landmark, NULL);
-
-    cairo_move_to(cr, 10, INIT_POSITION_RUNTIME_STR + 20);
-    snprintf(runtime_str, sizeof(runtime_str),
-             "Pose landmark avg. inference time: %.2f ms",
-             (data->pose_detected ? (data->inference_time_landmark / 1000.0)
-                                  : 0.00));
-    cairo_show_text(cr, runtime_str);
+  // Get the latest result published by the classification worker
+  ClassificationFrame frame = data->classification_worker->get_latest();
+  data->result = frame.result;
+  data->app_metrics.classification_latency->set(
+      (frame.timestamp - frame.capture_timestamp) / 1000.0);
+  if (frame.pose_detected)
+    data->landmark = frame.landmark;
+
+  // Repetitions are counted by the classification worker, show the ones
+  // of the active exercise
+  size_t active = frame.active_exercise;
+  const Exercise &exercise = data->engine->get_exercise(active);
+
+  // Confidences are drawn with a resolution of 0.1, so changes that would
+  // not be visible do not rasterize the layer again
+  float up_confidence =
+      std::round(data->result.get_class_confidence(exercise.up_class_id) *
+                 10.0) /
+      10.0;
+  float down_confidence =
+      std::round(data->result.get_class_confidence(exercise.down_class_id) *
+                 10.0) /
+      10.0;
+  snprintf(key, sizeof(key), "%s %.1f %.1f", exercise.label.c_str(),
+           up_confidence, down_confidence);
+  contents = key;
+  if (data->exercise_layer->is_stale(contents)) {
+    cairo_t *cr = data->exercise_layer->begin(
+        contents, 0, HEIGHT - EXERCISE_HEIGHT, WIDTH, EXERCISE_HEIGHT);
+    cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL,
+                           CAIRO_FONT_WEIGHT_NORMAL);
+    char label_str[256];
 
     cairo_set_font_size(cr, FONT_SIZE_RUNTIME + 2);
     cairo_move_to(cr, 10, INIT_POSITION_RUNTIME_STR + HEIGHT - 55);
-    cairo_set_source_rgb(
-        cr, 1.0 - data->result.get_class_confidence("squats_up") / 10.0,
-        data->result.get_class_confidence("squats_up") / 10.0, 0.0);
-    snprintf(runtime_str, sizeof(runtime_str), "Squat-Up");
-    cairo_show_text(cr, runtime_str);
+    cairo_set_source_rgb(cr, 1.0 - up_confidence / 10.0, up_confidence / 10.0,
+                         0.0);
+    snprintf(label_str, sizeof(label_str), "%s-Up", exercise.label.c_str());
+    cairo_show_text(cr, label_str);
 
     cairo_move_to(cr, WIDTH - 230, INIT_POSITION_RUNTIME_STR + HEIGHT - 55);
-    cairo_set_source_rgb(
-        cr, 1.0 - data->result.get_class_confidence("squats_down") / 10.0,
-        data->result.get_class_confidence("squats_down") / 10.0, 0.0);
-    snprintf(runtime_str, sizeof(runtime_str), "Squat-Down");
-    cairo_show_text(cr, runtime_str);
+    cairo_set_source_rgb(cr, 1.0 - down_confidence / 10.0,
+                         down_confidence / 10.0, 0.0);
+    snprintf(label_str, sizeof(label_str), "%s-Down", exercise.label.c_str());
+    cairo_show_text(cr, label_str);
+
+    // Draw graph
+    cairo_set_line_width(cr, 15);
+    cairo_set_source_rgb(cr, 1.0 - down_confidence / 10.0,
+                         down_confidence / 10.0, 0.0);
+    cairo_move_to(cr, 0, HEIGHT - 15);
+    cairo_line_to(cr, down_confidence * 64, HEIGHT - 15);
+    cairo_stroke(cr);
 
-    // Draw count
+    data->exercise_layer->end(cr);
+    changed = true;
+  }
+
+  // Draw count
+  snprintf(key, sizeof(key), "x%d",
+           data->classification_worker->get_repetitions(active));
+  contents = key;
+  if (data->count_layer->is_stale(contents)) {
+    cairo_t *cr = data->count_layer->begin(contents, WIDTH - COUNT_WIDTH, 0,
+                                           COUNT_WIDTH, COUNT_HEIGHT);
+    cairo_select_font_face(cr, "Courier", CAIRO_FONT_SLANT_NORMAL,
+                           CAIRO_FONT_WEIGHT_NORMAL);
     cairo_set_font_size(cr, FONT_SIZE_RUNTIME + 20);
     cairo_move_to(cr, WIDTH - 100, INIT_POSITION_RUNTIME_STR + 40);
     cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-    snprintf(runtime_str, sizeof(runtime_str), "x%d",
-             data->counter->count(data->result));
-    cairo_show_text(cr, runtime_str);
+    cairo_show_text(cr, key);
+    data->count_layer->end(cr);
+    changed = true;
+  }
 
-    // Draw graph
-    cairo_set_line_width(cr, 15);
-    cairo_set_source_rgb(
-        cr, 1.0 - data->result.get_class_confidence("squats_down") / 10.0,
-        data->result.get_class_confidence("squats_down") / 10.0, 0.0);
-    cairo_move_to(cr, 0, HEIGHT - 15);
-    cairo_line_to(cr, data->result.get_class_confidence("squats_down") * 64,
-                  HEIGHT - 15);
+  // Pose box and skeleton, rasterized again for a new box or landmark
+  if (update_pose_roi(data)) {
+    snprintf(key, sizeof(key), "%d %d %d %d %d %" G_GINT64_FORMAT,
+             (int)data->left, (int)data->top, (int)data->pose("xmax"),
+             (int)data->pose("ymax"), data->pose_detected,
+             (gint64)frame.capture_timestamp);
+    contents = key;
+    if (data->pose_layer->is_stale(contents)) {
+      // Pose region and landmarks, which may fall outside of it, with room
+      // for the line width
+      float left = data->left;
+      float top = data->top;
+      float right = data->pose("xmax");
+      float bottom = data->pose("ymax");
+      if (data->pose_detected) {
+        for (size_t j{0}; j < 33; j++) {
+          float x = data->landmark(j)["x"] * data->roi_width + data->left;
+          float y = data->landmark(j)["y"] * data->roi_height + data->top;
+          left = std::min(left, x);
+          top = std::min(top, y);
+          right = std::max(right, x);
+          bottom = std::max(bottom, y);
+        }
+      }
+      int xmin = std::max(0, (int)left - POSE_MARGIN);
+      int ymin = std::max(0, (int)top - POSE_MARGIN);
+      int xmax = std::min(WIDTH, (int)right + POSE_MARGIN);
+      int ymax = std::min(HEIGHT, (int)bottom + POSE_MARGIN);
+      if (xmax > xmin && ymax > ymin) {
+        cairo_t *cr = data->pose_layer->begin(contents, xmin, ymin,
+                                              xmax - xmin, ymax - ymin);
+        draw_detections(data, cr);
+        data->pose_layer->end(cr);
+      } else {
+        data->pose_layer->clear();
+      }
+      changed = true;
+    }
+  } else if (data->pose_layer->get_rectangle() != nullptr) {
+    data->pose_layer->clear();
+    changed = true;
+  }
 
-    cairo_stroke(cr);
-    draw_detections(data, cr);
+  // Composition of the cached rectangles, built again when one changed
+  if (changed) {
+    if (data->composition != nullptr)
+      gst_video_overlay_composition_unref(data->composition);
+    data->composition = nullptr;
+
+    OverlayLayer *layers[4] = {data->hud_layer, data->exercise_layer,
+                               data->count_layer, data->pose_layer};
+    for (size_t i{0}; i < 4; i++) {
+      GstVideoOverlayRectangle *rectangle = layers[i]->get_rectangle();
+      if (rectangle == nullptr)
+        continue;
+      if (data->composition == nullptr)
+        data->composition = gst_video_overlay_composition_new(rectangle);
+      else
+        gst_video_overlay_composition_add_rectangle(data->composition,
+                                                    rectangle);
+    }
   }
+
+  if (data->composition == nullptr)
+    return NULL;
+  return gst_video_overlay_composition_ref(data->composition);
 }
 
 /**
@@ -943,8 +2552,8 @@ static void draw_overlay(GstElement *overlay, cairo_t *cr, guint64 timestamp,
 void preprocess_input_frame(const int &video_width, const int &video_height,
                             int &scaled_width, int &scaled_height,
                             AppData *data) {
-  int input_height = 224;
-  int input_width = 224;
+  int input_height = data->detection_input_size;
+  int input_width = data->detection_input_size;
 
   // Keep original aspect ratio to scale frame
   float scale_w = static_cast<float>(video_width) / input_width;
@@ -952,7 +2561,13 @@ void preprocess_input_frame(const int &video_width, const int &video_height,
   float ratio = static_cast<float>(video_width) / video_height;
   float input_ratio = static_cast<float>(input_width) / input_height;
 
-  if (scale_w > scale_h) {
+  if (!data->letterbox) {
+    // Frame is stretched, detections are normalized to the frame itself
+    scaled_width = input_width;
+    scaled_height = input_height;
+    data->pad_img_shape[0] = video_width;
+    data->pad_img_shape[1] = video_height;
+  } else if (scale_w > scale_h) {
     scaled_width = input_width;
     scaled_height = static_cast<int>(input_width / ratio);
     data->pad_img_shape[0] = video_width;
@@ -966,447 +2581,430 @@ void preprocess_input_frame(const int &video_width, const int &video_height,
 }
 
 /**
- * Funtion to draw bbox and landmarks
+ * Function to update the filtered pose region from the pose detections
  */
-void draw_detections(AppData *data, cairo_t *cr) {
+static bool update_pose_roi(AppData *data) {
 
   // Recover box location after resizing
   Keypoint pad_bbox(data->pad_img_shape[0], data->pad_img_shape[1]);
-  Keypoint center_bbox(WIDTH / 2, HEIGHT / 2);
-
-  PoseDetection pose;
-  int min_distance = WIDTH;
-  int index_bbox{-1};
-
-  // Get closest bbox to center of frame and only process for one person
-  for (size_t i{0};
-       i < data->pose_detection_interpreter->get_pose_detections().size();
-       i++) {
-    pose = data->pose_detection_interpreter->get_pose_detections().at(i);
-
-    Keypoint mid_hip_center(pose.get_mid_hip_center());
-    float distance = (mid_hip_center * pad_bbox) ^
-                     center_bbox; // Get distance between points
-    if (distance < min_distance) {
-      min_distance = distance;
-      index_bbox = i;
-    }
-  }
 
-  if (index_bbox >= 0) {
-    // Compute radius of body for bounding box
-    pose =
-        data->pose_detection_interpreter->get_pose_detections().at(index_bbox);
-    float radius =
-        (pose.get_full_body_size_rotation() ^ pose.get_mid_hip_center()) *
-        pad_bbox["y"];
+  // Detections are updated by the tensor_sink thread
+  BoundingBox tmp;
+  g_mutex_lock(&data->g_mutex);
+  bool found =
+      get_pose_roi(data->pose_detection_interpreter->get_pose_detections(),
+                   pad_bbox, WIDTH, HEIGHT, tmp);
+  g_mutex_unlock(&data->g_mutex);
+  if (!found)
+    return false;
+
+  // Filter bounding box
+  data->pose = data->filter_bbox->filter(tmp);
+
+  data->top = data->pose("ymin");
+  data->left = data->pose("xmin");
+  data->bottom = HEIGHT - data->pose("ymax");
+  data->right = WIDTH - data->pose("xmax");
+
+  data->roi_width_bbox = data->right - data->left;
+  data->roi_height_bbox = data->bottom - data->top;
+
+  data->roi_width = data->pose("xmax") - data->left;
+  data->roi_height = data->pose("ymax") - data->top;
+  return true;
+}
 
-    // Create main pose bbox
-    BoundingBox tmp((pose.get_mid_hip_center() * pad_bbox) - radius,
-                    (pose.get_mid_hip_center() * pad_bbox) + radius);
+/**
+ * Funtion to draw bbox and landmarks
+ */
+void draw_detections(AppData *data, cairo_t *cr) {
+  if (data->pose_detected) {
+    // Set color to green to show that landmarks will be printed
+    cairo_set_source_rgb(cr, 0.0, 1.0, 0.0);
+  } else {
+    // Set color to red to show that landmarks won't be printed.
+    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+  }
 
-    // Filter bounding box
-    data->pose = data->filter_bbox->filter(tmp);
+  cairo_set_line_width(cr, 3);
+
+  //** Draw Pose Box **
+  cairo_move_to(cr, data->left, data->top);
+  cairo_line_to(cr, data->pose("xmax"), data->top);
+  cairo_line_to(cr, data->pose("xmax"), data->pose("ymax"));
+  cairo_line_to(cr, data->left, data->pose("ymax"));
+  cairo_close_path(cr);
+  cairo_stroke(cr);
+
+  //** Draw landmarks **
+  if (data->pose_detected) {
+    cairo_set_source_rgb(cr, 1.0, 0.64705882, 0.0); // Orange
+    cairo_move_to(cr,
+                  data->landmark["nose"]["x"] * data->roi_width + data->left,
+                  data->landmark["nose"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_eye"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_ear"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ear"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    data->top = data->pose("ymin");
-    data->left = data->pose("xmin");
-    data->bottom = HEIGHT - data->pose("ymax");
-    data->right = WIDTH - data->pose("xmax");
+    cairo_set_source_rgb(cr, 0.0, 1.0, 1.0); // Blue
+    cairo_move_to(cr,
+                  data->landmark["nose"]["x"] * data->roi_width + data->left,
+                  data->landmark["nose"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_eye"]["x"] * data->roi_width + data->left,
+        data->landmark["right_eye"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ear"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    data->roi_width_bbox = data->right - data->left;
-    data->roi_height_bbox = data->bottom - data->top;
+    cairo_move_to(
+        cr, data->landmark["right_thumb"]["x"] * data->roi_width + data->left,
+        data->landmark["right_thumb"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_index"]["x"] * data->roi_width + data->left,
+        data->landmark["right_index"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_pinky"]["x"] * data->roi_width + data->left,
+        data->landmark["right_pinky"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["right_elbow"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr,
+        data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    data->roi_width = data->pose("xmax") - data->left;
-    data->roi_height = data->pose("ymax") - data->top;
+    cairo_set_source_rgb(cr, 1.0, 0.64705882, 0.0); // Orange
+    cairo_move_to(
+        cr,
+        data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["left_elbow"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_pinky"]["x"] * data->roi_width + data->left,
+        data->landmark["left_pinky"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_index"]["x"] * data->roi_width + data->left,
+        data->landmark["left_index"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_thumb"]["x"] * data->roi_width + data->left,
+        data->landmark["left_thumb"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    if (data->pose_detected) {
-      // Set color to green to show that landmarks will be printed
-      cairo_set_source_rgb(cr, 0.0, 1.0, 0.0);
-    } else {
-      // Set color to red to show that landmarks won't be printed.
-      cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-    }
+    cairo_move_to(
+        cr,
+        data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["left_hip"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_knee"]["x"] * data->roi_width + data->left,
+        data->landmark["left_knee"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_heel"]["x"] * data->roi_width + data->left,
+        data->landmark["left_heel"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_foot"]["x"] * data->roi_width + data->left,
+        data->landmark["left_foot"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    cairo_set_line_width(cr, 3);
+    cairo_set_source_rgb(cr, 0.0, 1.0, 1.0); // Blue
+    cairo_move_to(
+        cr,
+        data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["right_hip"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
+        data->landmark["right_knee"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
+        data->landmark["right_heel"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
+        data->landmark["right_foot"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
+    cairo_stroke(cr);
 
-    //** Draw Pose Box **
-    cairo_move_to(cr, data->left, data->top);
-    cairo_line_to(cr, data->pose("xmax"), data->top);
-    cairo_line_to(cr, data->pose("xmax"), data->pose("ymax"));
-    cairo_line_to(cr, data->left, data->pose("ymax"));
-    cairo_close_path(cr);
+    cairo_set_source_rgb(cr, 1.0, 1.0, 1.0); // White
+    cairo_move_to(
+        cr, data->landmark["mouth_left"]["x"] * data->roi_width + data->left,
+        data->landmark["mouth_left"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
+        data->landmark["mouth_right"]["y"] * data->roi_height + data->top);
+    cairo_move_to(
+        cr,
+        data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr,
+        data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_move_to(
+        cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["left_hip"]["y"] * data->roi_height + data->top);
+    cairo_line_to(
+        cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["right_hip"]["y"] * data->roi_height + data->top);
     cairo_stroke(cr);
 
-    //** Draw landmarks **
-    if (data->pose_detected) {
-      cairo_set_source_rgb(cr, 1.0, 0.64705882, 0.0); // Orange
-      cairo_move_to(cr,
-                    data->landmark["nose"]["x"] * data->roi_width + data->left,
-                    data->landmark["nose"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_eye"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_ear"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ear"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_set_source_rgb(cr, 0.0, 1.0, 1.0); // Blue
-      cairo_move_to(cr,
-                    data->landmark["nose"]["x"] * data->roi_width + data->left,
-                    data->landmark["nose"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_eye"]["x"] * data->roi_width + data->left,
-          data->landmark["right_eye"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ear"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_move_to(
-          cr, data->landmark["right_thumb"]["x"] * data->roi_width + data->left,
-          data->landmark["right_thumb"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_index"]["x"] * data->roi_width + data->left,
-          data->landmark["right_index"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_pinky"]["x"] * data->roi_width + data->left,
-          data->landmark["right_pinky"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["right_elbow"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr,
-          data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_set_source_rgb(cr, 1.0, 0.64705882, 0.0); // Orange
-      cairo_move_to(
-          cr,
-          data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["left_elbow"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_pinky"]["x"] * data->roi_width + data->left,
-          data->landmark["left_pinky"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_index"]["x"] * data->roi_width + data->left,
-          data->landmark["left_index"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_thumb"]["x"] * data->roi_width + data->left,
-          data->landmark["left_thumb"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_move_to(
-          cr,
-          data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["left_hip"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_knee"]["x"] * data->roi_width + data->left,
-          data->landmark["left_knee"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_heel"]["x"] * data->roi_width + data->left,
-          data->landmark["left_heel"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_foot"]["x"] * data->roi_width + data->left,
-          data->landmark["left_foot"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_set_source_rgb(cr, 0.0, 1.0, 1.0); // Blue
-      cairo_move_to(
-          cr,
-          data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["right_hip"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
-          data->landmark["right_knee"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
-          data->landmark["right_heel"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
-          data->landmark["right_foot"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      cairo_set_source_rgb(cr, 1.0, 1.0, 1.0); // White
-      cairo_move_to(
-          cr, data->landmark["mouth_left"]["x"] * data->roi_width + data->left,
-          data->landmark["mouth_left"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
-          data->landmark["mouth_right"]["y"] * data->roi_height + data->top);
-      cairo_move_to(
-          cr,
-          data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr,
-          data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_move_to(
-          cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["left_hip"]["y"] * data->roi_height + data->top);
-      cairo_line_to(
-          cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["right_hip"]["y"] * data->roi_height + data->top);
-      cairo_stroke(cr);
-
-      // Draw points
-      cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-      cairo_arc(
-          cr, data->landmark["mouth_left"]["x"] * data->roi_width + data->left,
-          data->landmark["mouth_left"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
-          data->landmark["mouth_right"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
-          data->landmark["mouth_right"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr,
-          data->landmark["left_eye_inner"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye_inner"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr,
-          data->landmark["left_eye_inner"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye_inner"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_eye"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_eye"]["x"] * data->roi_width + data->left,
-                data->landmark["left_eye"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr,
-          data->landmark["left_eye_outer"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye_outer"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr,
-          data->landmark["left_eye_outer"]["x"] * data->roi_width + data->left,
-          data->landmark["left_eye_outer"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_ear"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ear"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_ear"]["x"] * data->roi_width + data->left,
-                data->landmark["left_ear"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(cr,
-                    data->landmark["right_eye_inner"]["x"] * data->roi_width +
-                        data->left,
-                    data->landmark["right_eye_inner"]["y"] * data->roi_height +
-                        data->top);
-      cairo_arc(
-          cr,
-          data->landmark["right_eye_inner"]["x"] * data->roi_width + data->left,
-          data->landmark["right_eye_inner"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ear"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["right_ear"]["x"] * data->roi_width + data->left,
-                data->landmark["right_ear"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(cr,
-                    data->landmark["right_eye_outer"]["x"] * data->roi_width +
-                        data->left,
-                    data->landmark["right_eye_outer"]["y"] * data->roi_height +
-                        data->top);
-      cairo_arc(
-          cr,
-          data->landmark["right_eye_outer"]["x"] * data->roi_width + data->left,
-          data->landmark["right_eye_outer"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ear"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["right_ear"]["x"] * data->roi_width + data->left,
-                data->landmark["right_ear"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr,
-          data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr,
-          data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["left_shoulder"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr,
-          data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr,
-          data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
-          data->landmark["right_shoulder"]["y"] * data->roi_height + data->top,
-          1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["left_hip"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_hip"]["x"] * data->roi_width + data->left,
-                data->landmark["left_hip"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
-          data->landmark["right_hip"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["right_hip"]["x"] * data->roi_width + data->left,
-                data->landmark["right_hip"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_knee"]["x"] * data->roi_width + data->left,
-          data->landmark["left_knee"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_knee"]["x"] * data->roi_width + data->left,
-                data->landmark["left_knee"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
-          data->landmark["right_knee"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
-          data->landmark["right_knee"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["left_ankle"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
-          data->landmark["right_ankle"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_heel"]["x"] * data->roi_width + data->left,
-          data->landmark["left_heel"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_heel"]["x"] * data->roi_width + data->left,
-                data->landmark["left_heel"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
-          data->landmark["right_heel"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
-          data->landmark["right_heel"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_foot"]["x"] * data->roi_width + data->left,
-          data->landmark["left_foot"]["y"] * data->roi_height + data->top);
-      cairo_arc(cr,
-                data->landmark["left_foot"]["x"] * data->roi_width + data->left,
-                data->landmark["left_foot"]["y"] * data->roi_height + data->top,
-                1, 0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
-          data->landmark["right_foot"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
-          data->landmark["right_foot"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["left_elbow"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["left_elbow"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["right_elbow"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
-          data->landmark["right_elbow"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["left_wrist"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_move_to(
-          cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
-      cairo_arc(
-          cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
-          data->landmark["right_wrist"]["y"] * data->roi_height + data->top, 1,
-          0, 2 * M_PI);
-
-      cairo_stroke(cr);
-    }
+    // Draw points
+    cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
+    cairo_arc(
+        cr, data->landmark["mouth_left"]["x"] * data->roi_width + data->left,
+        data->landmark["mouth_left"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
+        data->landmark["mouth_right"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["mouth_right"]["x"] * data->roi_width + data->left,
+        data->landmark["mouth_right"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr,
+        data->landmark["left_eye_inner"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye_inner"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr,
+        data->landmark["left_eye_inner"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye_inner"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_eye"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_eye"]["x"] * data->roi_width + data->left,
+              data->landmark["left_eye"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr,
+        data->landmark["left_eye_outer"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye_outer"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr,
+        data->landmark["left_eye_outer"]["x"] * data->roi_width + data->left,
+        data->landmark["left_eye_outer"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_ear"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ear"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_ear"]["x"] * data->roi_width + data->left,
+              data->landmark["left_ear"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(cr,
+                  data->landmark["right_eye_inner"]["x"] * data->roi_width +
+                      data->left,
+                  data->landmark["right_eye_inner"]["y"] * data->roi_height +
+                      data->top);
+    cairo_arc(
+        cr,
+        data->landmark["right_eye_inner"]["x"] * data->roi_width + data->left,
+        data->landmark["right_eye_inner"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ear"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["right_ear"]["x"] * data->roi_width + data->left,
+              data->landmark["right_ear"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(cr,
+                  data->landmark["right_eye_outer"]["x"] * data->roi_width +
+                      data->left,
+                  data->landmark["right_eye_outer"]["y"] * data->roi_height +
+                      data->top);
+    cairo_arc(
+        cr,
+        data->landmark["right_eye_outer"]["x"] * data->roi_width + data->left,
+        data->landmark["right_eye_outer"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_ear"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ear"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["right_ear"]["x"] * data->roi_width + data->left,
+              data->landmark["right_ear"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr,
+        data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["left_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr,
+        data->landmark["left_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["left_shoulder"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr,
+        data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["right_shoulder"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr,
+        data->landmark["right_shoulder"]["x"] * data->roi_width + data->left,
+        data->landmark["right_shoulder"]["y"] * data->roi_height + data->top,
+        1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["left_hip"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_hip"]["x"] * data->roi_width + data->left,
+              data->landmark["left_hip"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_hip"]["x"] * data->roi_width + data->left,
+        data->landmark["right_hip"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["right_hip"]["x"] * data->roi_width + data->left,
+              data->landmark["right_hip"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_knee"]["x"] * data->roi_width + data->left,
+        data->landmark["left_knee"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_knee"]["x"] * data->roi_width + data->left,
+              data->landmark["left_knee"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
+        data->landmark["right_knee"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_knee"]["x"] * data->roi_width + data->left,
+        data->landmark["right_knee"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ankle"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["left_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["left_ankle"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ankle"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_ankle"]["x"] * data->roi_width + data->left,
+        data->landmark["right_ankle"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_heel"]["x"] * data->roi_width + data->left,
+        data->landmark["left_heel"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_heel"]["x"] * data->roi_width + data->left,
+              data->landmark["left_heel"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
+        data->landmark["right_heel"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_heel"]["x"] * data->roi_width + data->left,
+        data->landmark["right_heel"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_foot"]["x"] * data->roi_width + data->left,
+        data->landmark["left_foot"]["y"] * data->roi_height + data->top);
+    cairo_arc(cr,
+              data->landmark["left_foot"]["x"] * data->roi_width + data->left,
+              data->landmark["left_foot"]["y"] * data->roi_height + data->top,
+              1, 0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
+        data->landmark["right_foot"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_foot"]["x"] * data->roi_width + data->left,
+        data->landmark["right_foot"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["left_elbow"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["left_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["left_elbow"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["right_elbow"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_elbow"]["x"] * data->roi_width + data->left,
+        data->landmark["right_elbow"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["left_wrist"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["left_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["left_wrist"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_move_to(
+        cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["right_wrist"]["y"] * data->roi_height + data->top);
+    cairo_arc(
+        cr, data->landmark["right_wrist"]["x"] * data->roi_width + data->left,
+        data->landmark["right_wrist"]["y"] * data->roi_height + data->top, 1,
+        0, 2 * M_PI);
+
+    cairo_stroke(cr);
   }
 }
 
@@ -1416,11 +3014,7 @@ void draw_detections(AppData *data, cairo_t *cr) {
 void sigint_handler(int signum) {
   UNUSED(signum);
   if (data.pipeline != nullptr) {
-    if (data.source_id != 0) {
-      g_print("Stop feeding...\n");
-      g_source_remove(data.source_id);
-      data.source_id = 0;
-    }
+    data.appsrc_ready = false;
     gst_element_send_event(data.pipeline, gst_event_new_eos());
   }
 }
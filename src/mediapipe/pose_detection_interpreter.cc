@@ -8,13 +8,35 @@
 PoseDetectionInterpreter::PoseDetectionInterpreter(const char *anchors_file,
                                                    const int &num_detections,
                                                    const int &num_keypoints)
-    : scores{nullptr}, raw_bbox{nullptr}, scale{224.0}, score_threshold{0.5},
-      nms_threshold{0.3} {
+    : scores{nullptr}, raw_bbox{nullptr}, scale{224.0}, scores_index{1},
+      boxes_index{0}, configured{false}, score_threshold{0.5},
+      nms_threshold{0.3}, anchors_x{POSE_DETECTION_ANCHORS.x_center},
+      anchors_y{POSE_DETECTION_ANCHORS.y_center},
+      num_anchors{POSE_DETECTION_ANCHORS.size()} {
   this->num_detections = num_detections;
   this->num_keypoints = num_keypoints;
 
-  scores = new float[this->num_detections];
-  raw_bbox = new float[this->num_detections * this->num_keypoints];
+  allocate_buffers();
+  if (anchors_file != nullptr)
+    load_anchors(anchors_file);
+}
+
+PoseDetectionInterpreter::~PoseDetectionInterpreter() {
+  if (nullptr != scores) {
+    delete[] scores;
+    scores = nullptr;
+  }
+  if (nullptr != raw_bbox) {
+    delete[] raw_bbox;
+    raw_bbox = nullptr;
+  }
+}
+
+void PoseDetectionInterpreter::allocate_buffers() {
+  delete[] scores;
+  delete[] raw_bbox;
+  scores = new float[num_detections];
+  raw_bbox = new float[num_detections * num_keypoints];
 
   // Check if memory was allocated
   if (nullptr == scores || nullptr == raw_bbox) {
@@ -23,26 +45,74 @@ PoseDetectionInterpreter::PoseDetectionInterpreter(const char *anchors_file,
   }
 
   // Initialize to zero
-  memset(scores, 0.0, sizeof(float) * this->num_detections);
-  memset(raw_bbox, 0.0,
-         sizeof(float) * this->num_detections * this->num_keypoints);
+  memset(scores, 0.0, sizeof(float) * num_detections);
+  memset(raw_bbox, 0.0, sizeof(float) * num_detections * num_keypoints);
 
-  anchors = load_anchors(anchors_file);
+  detected_poses.reserve(num_detections);
+  candidate_poses.reserve(num_detections);
+  suppressed.reserve(num_detections);
 }
 
-PoseDetectionInterpreter::~PoseDetectionInterpreter() {
-  if (nullptr != scores) {
-    delete[] scores;
-    scores = nullptr;
+bool PoseDetectionInterpreter::configure(const std::vector<TensorSpec> &outputs,
+                                         const int &input_size) {
+  // Scores are [1, detections, 1], boxes are [1, detections, values] with the
+  // box and at least the 2 full body keypoints
+  bool has_scores = false;
+  bool has_boxes = false;
+  for (size_t i{0}; i < outputs.size(); i++) {
+    const TensorSpec &output = outputs.at(i);
+    if (!has_scores && output.dim(0) == 1 && output.dim(1) > 1 &&
+        output.size() == output.dim(1)) {
+      scores_index = i;
+      has_scores = true;
+    }
   }
-  if (nullptr != raw_bbox) {
-    delete[] raw_bbox;
-    raw_bbox = nullptr;
+  for (size_t i{0}; has_scores && i < outputs.size(); i++) {
+    const TensorSpec &output = outputs.at(i);
+    if (!has_boxes && output.dim(0) >= 8 &&
+        output.dim(1) == outputs.at(scores_index).dim(1) &&
+        output.size() == output.dim(0) * output.dim(1)) {
+      boxes_index = i;
+      has_boxes = true;
+    }
+  }
+  if (!has_scores || !has_boxes) {
+    std::cerr << "Pose detection model outputs not recognized!\n";
+    return false;
   }
+  if (!outputs.at(scores_index).is_float || !outputs.at(boxes_index).is_float) {
+    std::cerr << "Pose detection model outputs must be float32!\n";
+    return false;
+  }
+
+  size_t detections = outputs.at(scores_index).dim(1);
+  size_t keypoints = outputs.at(boxes_index).dim(0);
+  if (num_anchors != detections) {
+    std::cerr << "Anchors do not match the pose detection model: "
+              << num_anchors << " anchors for " << detections
+              << " detections, provide the anchors file of the model!\n";
+    return false;
+  }
+
+  if (detections != num_detections || keypoints != num_keypoints) {
+    num_detections = detections;
+    num_keypoints = keypoints;
+    allocate_buffers();
+  }
+  scale = input_size;
+  configured = true;
+  return true;
+}
+
+bool PoseDetectionInterpreter::is_configured() const { return configured; }
+
+size_t PoseDetectionInterpreter::get_scores_index() const {
+  return scores_index;
 }
 
-std::vector<float>
-PoseDetectionInterpreter::load_anchors(char const *filename) {
+size_t PoseDetectionInterpreter::get_boxes_index() const { return boxes_index; }
+
+void PoseDetectionInterpreter::load_anchors(char const *filename) {
   std::ifstream input_file;
 
   input_file.open(filename);
@@ -51,16 +121,26 @@ PoseDetectionInterpreter::load_anchors(char const *filename) {
     exit(-1);
   }
 
+  // Rows of x_center, y_center, width, height
   std::vector<float> anchor_box;
   float box{0.0};
-  while (true) {
-    input_file >> box;
+  while (input_file >> box)
     anchor_box.push_back(box);
-    if (input_file.eof() != 0)
-      break;
+  if (!input_file.eof() || anchor_box.empty() || anchor_box.size() % 4 != 0) {
+    std::cerr << "Invalid anchors file " << filename << "!\n";
+    exit(-1);
   }
   input_file.close();
-  return anchor_box;
+
+  // Only the centers are used for decoding
+  num_anchors = anchor_box.size() / 4;
+  loaded_anchors.resize(num_anchors * 2);
+  for (size_t i{0}; i < num_anchors; i++) {
+    loaded_anchors[i] = anchor_box[i * 4 + 0];
+    loaded_anchors[num_anchors + i] = anchor_box[i * 4 + 1];
+  }
+  anchors_x = loaded_anchors.data();
+  anchors_y = loaded_anchors.data() + num_anchors;
 }
 
 void PoseDetectionInterpreter::decode_predictions(const float *raw_bbox,
@@ -74,7 +154,7 @@ void PoseDetectionInterpreter::decode_predictions(const float *raw_bbox,
     decode_scores();
 
     PoseDetection _detection;
-    std::vector<PoseDetection> poses;
+    candidate_poses.clear();
 
     // Filter scores > score_threshold
     for (size_t i{0}; i < num_detections; i++) {
@@ -84,12 +164,12 @@ void PoseDetectionInterpreter::decode_predictions(const float *raw_bbox,
         _detection.set_mid_hip_center(decode_mid_hip_center(i));
         _detection.set_full_body_size_rotation(
             decode_full_body_size_rotation(i));
-        poses.push_back(_detection);
+        candidate_poses.push_back(_detection);
       }
     }
 
     // Filter IoU
-    detected_poses = nms(poses, nms_threshold);
+    nms(candidate_poses, nms_threshold);
   }
 }
 
@@ -111,10 +191,8 @@ BoundingBox PoseDetectionInterpreter::decode_bbox(const size_t &index) {
   }
 
   // Decode bbox
-  centers_x = anchors.data()[index * 4 + 0] +
-              (raw_bbox[index * num_keypoints + 0] / scale);
-  centers_y = anchors.data()[index * 4 + 1] +
-              (raw_bbox[index * num_keypoints + 1] / scale);
+  centers_x = anchors_x[index] + (raw_bbox[index * num_keypoints + 0] / scale);
+  centers_y = anchors_y[index] + (raw_bbox[index * num_keypoints + 1] / scale);
   sides_w = raw_bbox[index * num_keypoints + 2] / scale;
   sides_h = raw_bbox[index * num_keypoints + 3] / scale;
 
@@ -135,9 +213,9 @@ Keypoint PoseDetectionInterpreter::decode_mid_hip_center(const size_t &index) {
   }
 
   // Decode keypoint
-  mid_hip_center_x = anchors.data()[index * 4 + 0] +
+  mid_hip_center_x = anchors_x[index] +
                      (raw_bbox[index * num_keypoints + 4] / scale);
-  mid_hip_center_y = anchors.data()[index * 4 + 1] +
+  mid_hip_center_y = anchors_y[index] +
                      (raw_bbox[index * num_keypoints + 5] / scale);
 
   Keypoint kp(mid_hip_center_x, mid_hip_center_y);
@@ -155,9 +233,9 @@ PoseDetectionInterpreter::decode_full_body_size_rotation(const size_t &index) {
   }
 
   // Decode keypoint
-  full_body_size_rotation_x = anchors.data()[index * 4 + 0] +
+  full_body_size_rotation_x = anchors_x[index] +
                               (raw_bbox[index * num_keypoints + 6] / scale);
-  full_body_size_rotation_y = anchors.data()[index * 4 + 1] +
+  full_body_size_rotation_y = anchors_y[index] +
                               (raw_bbox[index * num_keypoints + 7] / scale);
 
   Keypoint kp(full_body_size_rotation_x, full_body_size_rotation_y);
@@ -165,25 +243,25 @@ PoseDetectionInterpreter::decode_full_body_size_rotation(const size_t &index) {
   return kp;
 }
 
-std::vector<PoseDetection>
-PoseDetectionInterpreter::nms(std::vector<PoseDetection> &poses,
-                              const float &nms_threshold) {
+void PoseDetectionInterpreter::nms(std::vector<PoseDetection> &poses,
+                                   const float &nms_threshold) {
   std::sort(poses.begin(), poses.end(), comparer);
 
-  std::vector<PoseDetection> filtered_results;
-  while (poses.size() > 0) {
-    filtered_results.push_back(poses[0]);
-    size_t index = 1;
-    while (index < poses.size()) {
-      float iou_value = iou(poses[0].get_bbox(), poses[index].get_bbox());
+  // Greedy suppression in place, kept poses are written to detected_poses
+  detected_poses.clear();
+  suppressed.assign(poses.size(), false);
+  for (size_t i{0}; i < poses.size(); i++) {
+    if (suppressed[i])
+      continue;
+    detected_poses.push_back(poses[i]);
+    for (size_t index{i + 1}; index < poses.size(); index++) {
+      if (suppressed[index])
+        continue;
+      float iou_value = iou(poses[i].get_bbox(), poses[index].get_bbox());
       if (iou_value > nms_threshold)
-        poses.erase(poses.begin() + index);
-      else
-        index++;
+        suppressed[index] = true;
     }
-    poses.erase(poses.begin());
   }
-  return filtered_results;
 }
 
 float PoseDetectionInterpreter::iou(const BoundingBox &bbox_a,
@@ -210,6 +288,7 @@ bool PoseDetectionInterpreter::comparer(PoseDetection &score_a,
   return score_a.get_score() > score_b.get_score();
 }
 
-std::vector<PoseDetection> PoseDetectionInterpreter::get_pose_detections() {
+const std::vector<PoseDetection> &
+PoseDetectionInterpreter::get_pose_detections() const {
   return detected_poses;
 }
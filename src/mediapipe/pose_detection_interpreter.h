@@ -14,6 +14,8 @@
 #include <vector>
 
 #include "../utils/pose_detection.h"
+#include "../utils/tensor_spec.h"
+#include "ssd_anchors.h"
 
 class PoseDetectionInterpreter {
   float *scores;
@@ -23,32 +25,59 @@ class PoseDetectionInterpreter {
   size_t num_keypoints;
   float scale;
 
+  // Output tensors of the model, found by shape
+  size_t scores_index;
+  size_t boxes_index;
+  bool configured;
+
   const float score_threshold;
   const float nms_threshold;
-  std::vector<float> anchors;
+
+  // Anchor centers, built-in or loaded from a file (one array per
+  // coordinate)
+  const float *anchors_x;
+  const float *anchors_y;
+  size_t num_anchors;
+  std::vector<float> loaded_anchors;
 
   std::vector<PoseDetection> detected_poses; // Detected poses (decoded result)
 
+  // Per-frame buffers, sized once for the number of detections
+  std::vector<PoseDetection> candidate_poses;
+  std::vector<bool> suppressed;
+
   // Apply sigmoid to scores
   void decode_scores();
 
-  std::vector<float> load_anchors(char const *filename);
+  void load_anchors(char const *filename);
+  void allocate_buffers();
 
   BoundingBox decode_bbox(const size_t &index);
   Keypoint decode_mid_hip_center(const size_t &index);
   Keypoint decode_full_body_size_rotation(const size_t &index);
 
-  std::vector<PoseDetection> nms(std::vector<PoseDetection> &beposesfore,
-                                 const float &nms_threshold);
+  void nms(std::vector<PoseDetection> &poses, const float &nms_threshold);
   float iou(const BoundingBox &rectA, const BoundingBox &rectB);
   static bool comparer(PoseDetection &score_a, PoseDetection &score_b);
 
 public:
-  PoseDetectionInterpreter(const char *anchors_file,
+  // Anchors of the 224x224 model are used when no anchors file is given
+  PoseDetectionInterpreter(const char *anchors_file = nullptr,
                            const int &num_detections = 2254,
                            const int &num_keypoints = 12);
   ~PoseDetectionInterpreter();
 
+  // Configure the decoding from the negotiated output tensors and the size of
+  // the square model input, false with the reason printed if the outputs are
+  // not supported
+  bool configure(const std::vector<TensorSpec> &outputs,
+                 const int &input_size);
+  bool is_configured() const;
+  size_t get_scores_index() const;
+  size_t get_boxes_index() const;
+
   void decode_predictions(const float *raw_bbox, const float *scores);
-  std::vector<PoseDetection> get_pose_detections();
+  // Valid until the next decode_predictions(), which the caller must not run
+  // concurrently from another thread
+  const std::vector<PoseDetection> &get_pose_detections() const;
 };
@@ -5,14 +5,27 @@
 
 #include "pose_landmark_interpreter.h"
 
-PoseLandmarkInterpreter::PoseLandmarkInterpreter(const int &num_detections,
-                                                 const int &num_keypoints)
-    : score{0.0}, raw_landmarks{nullptr}, scale{256.0}, score_threshold{0.7},
+PoseLandmarkInterpreter::PoseLandmarkInterpreter(const int &num_landmarks,
+                                                 const int &num_values)
+    : score{0.0}, raw_landmarks{nullptr}, scale{256.0}, landmarks_index{0},
+      score_index{1}, configured{false}, score_threshold{0.7},
       pose_landmark{} {
-  this->num_detections = num_detections;
-  this->num_keypoints = num_keypoints;
+  this->num_landmarks = num_landmarks;
+  this->num_values = num_values;
 
-  raw_landmarks = new float[this->num_detections * this->num_keypoints];
+  allocate_buffers();
+}
+
+PoseLandmarkInterpreter::~PoseLandmarkInterpreter() {
+  if (nullptr != raw_landmarks) {
+    delete[] raw_landmarks;
+    raw_landmarks = nullptr;
+  }
+}
+
+void PoseLandmarkInterpreter::allocate_buffers() {
+  delete[] raw_landmarks;
+  raw_landmarks = new float[num_landmarks * num_values];
 
   // Check if memory was allocated
   if (nullptr == raw_landmarks) {
@@ -21,38 +34,109 @@ PoseLandmarkInterpreter::PoseLandmarkInterpreter(const int &num_detections,
   }
 
   // Initialize to zero
-  memset(raw_landmarks, 0.0,
-         sizeof(float) * this->num_detections * this->num_keypoints);
+  memset(raw_landmarks, 0.0, sizeof(float) * num_landmarks * num_values);
 }
 
-PoseLandmarkInterpreter::~PoseLandmarkInterpreter() {
-  if (nullptr != raw_landmarks) {
-    delete[] raw_landmarks;
-    raw_landmarks = nullptr;
+bool PoseLandmarkInterpreter::find_outputs(
+    const std::vector<TensorSpec> &outputs, size_t &landmarks,
+    size_t &score) const {
+  // Score is a single value, landmarks are a flat [1, landmarks * values]
+  // tensor. Heatmap, segmentation and world landmarks are ignored.
+  bool has_landmarks = false;
+  bool has_score = false;
+  for (size_t i{0}; i < outputs.size(); i++) {
+    const TensorSpec &output = outputs.at(i);
+    if (!has_score && output.size() == 1) {
+      score = i;
+      has_score = true;
+    } else if (!has_landmarks && output.dim(0) == output.size() &&
+               output.size() % num_values == 0 &&
+               output.size() / num_values >= 33) {
+      landmarks = i;
+      has_landmarks = true;
+    }
+  }
+  return has_landmarks && has_score;
+}
+
+bool PoseLandmarkInterpreter::configure(const std::vector<TensorSpec> &outputs,
+                                        const int &input_size) {
+  if (!find_outputs(outputs, landmarks_index, score_index)) {
+    std::cerr << "Pose landmark model outputs not recognized!\n";
+    return false;
+  }
+  if (!outputs.at(landmarks_index).is_float ||
+      !outputs.at(score_index).is_float) {
+    std::cerr << "Pose landmark model outputs must be float32!\n";
+    return false;
+  }
+
+  int landmarks = outputs.at(landmarks_index).size() / num_values;
+  if (landmarks != num_landmarks) {
+    num_landmarks = landmarks;
+    allocate_buffers();
   }
+  scale = input_size;
+  configured = true;
+  return true;
 }
 
-void PoseLandmarkInterpreter::decode_predictions(const float *raw_landmarks,
+bool PoseLandmarkInterpreter::is_configured() const { return configured; }
+
+std::string PoseLandmarkInterpreter::get_output_combination(
+    const std::vector<TensorSpec> &outputs, size_t &pruned_bytes) const {
+  size_t landmarks = 0;
+  size_t score = 0;
+  pruned_bytes = 0;
+  if (!find_outputs(outputs, landmarks, score))
+    return "";
+
+  for (size_t i{0}; i < outputs.size(); i++) {
+    if (i != landmarks && i != score)
+      pruned_bytes += outputs.at(i).bytes;
+  }
+  return "o" + std::to_string(landmarks) + ",o" + std::to_string(score);
+}
+
+size_t PoseLandmarkInterpreter::get_landmarks_index() const {
+  return landmarks_index;
+}
+
+size_t PoseLandmarkInterpreter::get_score_index() const { return score_index; }
+
+bool PoseLandmarkInterpreter::decode_predictions(const float *raw_landmarks,
                                                  float &score) {
   if (nullptr != raw_landmarks) {
     memcpy(this->raw_landmarks, raw_landmarks,
-           sizeof(float) * num_detections * num_keypoints);
+           sizeof(float) * num_landmarks * num_values);
 
     // Apply sigmoid to score
     score = 1.0 / (1.0 + std::exp(-score));
 
     if (score > score_threshold) {
       decode_landmark();
+      return true;
     }
   }
+  return false;
 }
 
 void PoseLandmarkInterpreter::decode_landmark() {
   for (size_t i{0}; i < 33; i++) {
-    Keypoint keypoint(raw_landmarks[i * num_keypoints + 0],
-                      raw_landmarks[i * num_keypoints + 1],
-                      raw_landmarks[i * num_keypoints + 2]);
+    Keypoint keypoint(raw_landmarks[i * num_values + 0],
+                      raw_landmarks[i * num_values + 1],
+                      raw_landmarks[i * num_values + 2]);
     pose_landmark[i] = keypoint / scale;
+
+    // Visibility and presence are logits, models with 3 values per landmark
+    // are considered fully visible
+    if (num_values >= 5) {
+      pose_landmark.set_scores(
+          i, 1.0 / (1.0 + std::exp(-raw_landmarks[i * num_values + 3])),
+          1.0 / (1.0 + std::exp(-raw_landmarks[i * num_values + 4])));
+    } else {
+      pose_landmark.set_scores(i, 1.0, 1.0);
+    }
   }
 }
 
@@ -11,29 +11,57 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "../utils/pose_landmark.h"
+#include "../utils/tensor_spec.h"
 
 class PoseLandmarkInterpreter {
   float score;
   float *raw_landmarks;
 
-  int num_detections;
-  int num_keypoints;
+  int num_landmarks; // Landmarks in the model output, 33 body + auxiliary
+  int num_values;    // Values per landmark
   float scale;
 
+  // Output tensors of the model, found by shape
+  size_t landmarks_index;
+  size_t score_index;
+  bool configured;
+
   const float score_threshold;
 
   Landmark pose_landmark;
 
+  // Find the landmarks and score tensors by shape
+  bool find_outputs(const std::vector<TensorSpec> &outputs, size_t &landmarks,
+                    size_t &score) const;
   void decode_landmark();
+  void allocate_buffers();
 
 public:
-  PoseLandmarkInterpreter(const int &num_detections = 195,
-                          const int &num_keypoints = 5);
+  PoseLandmarkInterpreter(const int &num_landmarks = 39,
+                          const int &num_values = 5);
   ~PoseLandmarkInterpreter();
 
-  void decode_predictions(const float *raw_landmarks, float &score);
+  // Configure the decoding from the negotiated output tensors and the size of
+  // the square model input, false with the reason printed if the outputs are
+  // not supported
+  bool configure(const std::vector<TensorSpec> &outputs,
+                 const int &input_size);
+  bool is_configured() const;
+
+  // NNStreamer output combination keeping the landmarks and score tensors of
+  // the model outputs, with the size of the tensors left out. Empty if the
+  // outputs are not recognized.
+  std::string get_output_combination(const std::vector<TensorSpec> &outputs,
+                                     size_t &pruned_bytes) const;
+  size_t get_landmarks_index() const;
+  size_t get_score_index() const;
+
+  // Returns true if the score passed the threshold and the landmark was
+  // decoded, the previous landmark is kept otherwise
+  bool decode_predictions(const float *raw_landmarks, float &score);
   Landmark get_pose_landmark();
 };
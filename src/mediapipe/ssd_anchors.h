@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Compile-time SSD anchors generation
+ *
+ * Same generation as models/generate_anchors.py (MediaPipe
+ * SsdAnchorsCalculator), evaluated by the compiler, so the anchors of the
+ * pose detection model are baked into the binary. Anchors are stored as one
+ * array per coordinate, each aligned to a cache line.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#define SSD_MAX_LAYERS 8
+#define SSD_MAX_ASPECT_RATIOS 4
+
+struct SsdAnchorOptions {
+  int num_layers;
+  float min_scale;
+  float max_scale;
+  int input_size_height;
+  int input_size_width;
+  float anchor_offset_x;
+  float anchor_offset_y;
+  int strides[SSD_MAX_LAYERS];
+  int num_aspect_ratios;
+  float aspect_ratios[SSD_MAX_ASPECT_RATIOS];
+  bool reduce_boxes_in_lowest_layer;
+  float interpolated_scale_aspect_ratio;
+  bool fixed_anchor_size;
+};
+
+template <size_t N> struct SsdAnchors {
+  alignas(64) float x_center[N];
+  alignas(64) float y_center[N];
+  alignas(64) float width[N];
+  alignas(64) float height[N];
+
+  static constexpr size_t size() { return N; }
+};
+
+// Options of the MediaPipe pose detection model (224x224 input)
+constexpr SsdAnchorOptions POSE_DETECTION_ANCHOR_OPTIONS = {
+    5,                   // num_layers
+    0.1484375,           // min_scale
+    0.75,                // max_scale
+    224,                 // input_size_height
+    224,                 // input_size_width
+    0.5,                 // anchor_offset_x
+    0.5,                 // anchor_offset_y
+    {8, 16, 32, 32, 32}, // strides
+    1,                   // num_aspect_ratios
+    {1.0},               // aspect_ratios
+    false,               // reduce_boxes_in_lowest_layer
+    1.0,                 // interpolated_scale_aspect_ratio
+    true};               // fixed_anchor_size
+
+namespace ssd_anchors {
+
+constexpr double sqrt(const double &value) {
+  // Newton iterations, std::sqrt is not constexpr
+  if (value <= 0.0)
+    return 0.0;
+  double root = value > 1.0 ? value : 1.0;
+  for (size_t i{0}; i < 64; i++)
+    root = 0.5 * (root + value / root);
+  return root;
+}
+
+constexpr double calculate_scale(const SsdAnchorOptions &options,
+                                 const int &stride_index) {
+  return options.min_scale + (options.max_scale - options.min_scale) *
+                                 stride_index / (options.num_layers - 1.0);
+}
+
+constexpr int feature_map_size(const int &input_size, const int &stride) {
+  return (input_size + stride - 1) / stride;
+}
+
+// Fills the scales and aspect ratios of the layers sharing the stride of
+// layer_id, returns the number of anchors per feature map cell
+constexpr size_t layer_anchors(const SsdAnchorOptions &options,
+                               const int &layer_id, int &last_layer,
+                               double *scales, double *aspect_ratios) {
+  size_t count = 0;
+  last_layer = layer_id;
+  while (last_layer < options.num_layers &&
+         options.strides[last_layer] == options.strides[layer_id]) {
+    double scale = calculate_scale(options, last_layer);
+    if (last_layer == 0 && options.reduce_boxes_in_lowest_layer) {
+      // For first layer, it can be specified to use predefined anchors
+      const double ratios[3] = {1.0, 2.0, 0.5};
+      const double first_scales[3] = {0.1, scale, scale};
+      for (size_t i{0}; i < 3; i++) {
+        if (scales != nullptr) {
+          scales[count] = first_scales[i];
+          aspect_ratios[count] = ratios[i];
+        }
+        count++;
+      }
+    } else {
+      for (int i{0}; i < options.num_aspect_ratios; i++) {
+        if (scales != nullptr) {
+          scales[count] = scale;
+          aspect_ratios[count] = options.aspect_ratios[i];
+        }
+        count++;
+      }
+      if (options.interpolated_scale_aspect_ratio > 0.0) {
+        double scale_next = (last_layer == options.num_layers - 1)
+                                ? 1.0
+                                : calculate_scale(options, last_layer + 1);
+        if (scales != nullptr) {
+          scales[count] = sqrt(scale * scale_next);
+          aspect_ratios[count] = options.interpolated_scale_aspect_ratio;
+        }
+        count++;
+      }
+    }
+    last_layer++;
+  }
+  return count;
+}
+
+} // namespace ssd_anchors
+
+// Number of anchors generated for the options
+constexpr size_t count_ssd_anchors(const SsdAnchorOptions &options) {
+  size_t count = 0;
+  int layer_id = 0;
+  while (layer_id < options.num_layers) {
+    int last_layer = layer_id;
+    size_t per_cell = ssd_anchors::layer_anchors(options, layer_id, last_layer,
+                                                 nullptr, nullptr);
+    int stride = options.strides[layer_id];
+    count += per_cell *
+             ssd_anchors::feature_map_size(options.input_size_height, stride) *
+             ssd_anchors::feature_map_size(options.input_size_width, stride);
+    layer_id = last_layer;
+  }
+  return count;
+}
+
+template <size_t N>
+constexpr SsdAnchors<N> generate_ssd_anchors(const SsdAnchorOptions &options) {
+  static_assert(N > 0, "No anchors to generate");
+  SsdAnchors<N> anchors{};
+  size_t index = 0;
+  int layer_id = 0;
+  while (layer_id < options.num_layers) {
+    int last_layer = layer_id;
+    double scales[SSD_MAX_LAYERS * (SSD_MAX_ASPECT_RATIOS + 3)] = {};
+    double aspect_ratios[SSD_MAX_LAYERS * (SSD_MAX_ASPECT_RATIOS + 3)] = {};
+    size_t per_cell = ssd_anchors::layer_anchors(options, layer_id, last_layer,
+                                                 scales, aspect_ratios);
+
+    int stride = options.strides[layer_id];
+    int height =
+        ssd_anchors::feature_map_size(options.input_size_height, stride);
+    int width = ssd_anchors::feature_map_size(options.input_size_width, stride);
+    for (int y{0}; y < height; y++) {
+      for (int x{0}; x < width; x++) {
+        for (size_t i{0}; i < per_cell && index < N; i++) {
+          double ratio_sqrt = ssd_anchors::sqrt(aspect_ratios[i]);
+          anchors.x_center[index] =
+              (x + (double)options.anchor_offset_x) / width;
+          anchors.y_center[index] =
+              (y + (double)options.anchor_offset_y) / height;
+          anchors.width[index] =
+              options.fixed_anchor_size ? 1.0 : scales[i] * ratio_sqrt;
+          anchors.height[index] =
+              options.fixed_anchor_size ? 1.0 : scales[i] / ratio_sqrt;
+          index++;
+        }
+      }
+    }
+    layer_id = last_layer;
+  }
+  return anchors;
+}
+
+// Anchors of the pose detection model, computed at compile time
+constexpr size_t POSE_DETECTION_NUM_ANCHORS =
+    count_ssd_anchors(POSE_DETECTION_ANCHOR_OPTIONS);
+static_assert(POSE_DETECTION_NUM_ANCHORS == 2254,
+              "Unexpected number of pose detection anchors");
+inline constexpr SsdAnchors<POSE_DETECTION_NUM_ANCHORS>
+    POSE_DETECTION_ANCHORS = generate_ssd_anchors<POSE_DETECTION_NUM_ANCHORS>(
+        POSE_DETECTION_ANCHOR_OPTIONS);
@@ -6,13 +6,14 @@
 #include "ema_filter.h"
 
 Filter::Filter()
-    : window_size{10}, alpha{0.1}, alpha_landmarks{0.4}, data(),
-      data_landmark() {}
+    : alpha{0.1}, alpha_landmarks{0.4}, data(), head{0}, size{0},
+      data_landmark(), head_landmark{0}, size_landmark{0} {}
 
 BoundingBox Filter::filter(BoundingBox &detection) {
-  data.insert(data.begin(), detection);
-  if (data.size() > window_size) {
-    data.pop_back();
+  head = (head + WINDOW_SIZE - 1) % WINDOW_SIZE;
+  data[head] = detection;
+  if (size < WINDOW_SIZE) {
+    size++;
   }
 
   BoundingBox smoothed_box;
@@ -21,8 +22,8 @@ BoundingBox Filter::filter(BoundingBox &detection) {
   BoundingBox top_sum;
   BoundingBox bottom_sum;
 
-  for (size_t i{0}; i < data.size(); i++) {
-    top_sum += (data.at(i) * factor);
+  for (size_t i{0}; i < size; i++) {
+    top_sum += (data[(head + i) % WINDOW_SIZE] * factor);
     bottom_sum += factor;
     factor *= (1.0 - alpha);
   }
@@ -33,9 +34,10 @@ BoundingBox Filter::filter(BoundingBox &detection) {
 }
 
 Landmark Filter::filter(Landmark &landmark) {
-  data_landmark.insert(data_landmark.begin(), landmark);
-  if (data_landmark.size() > window_size) {
-    data_landmark.pop_back();
+  head_landmark = (head_landmark + WINDOW_SIZE - 1) % WINDOW_SIZE;
+  data_landmark[head_landmark] = landmark;
+  if (size_landmark < WINDOW_SIZE) {
+    size_landmark++;
   }
 
   Landmark smoothed_box;
@@ -44,13 +46,16 @@ Landmark Filter::filter(Landmark &landmark) {
   Landmark top_sum;
   Landmark bottom_sum;
 
-  for (size_t i{0}; i < data_landmark.size(); i++) {
-    top_sum += (data_landmark.at(i) * factor);
+  for (size_t i{0}; i < size_landmark; i++) {
+    top_sum += (data_landmark[(head_landmark + i) % WINDOW_SIZE] * factor);
     bottom_sum += factor;
     factor *= (1.0 - alpha_landmarks);
   }
 
   smoothed_box = top_sum / bottom_sum;
 
+  // Scores are not smoothed, they are the ones of the newest landmark
+  smoothed_box.set_scores(landmark);
+
   return smoothed_box;
 }
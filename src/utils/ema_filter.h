@@ -5,17 +5,24 @@
 
 #pragma once
 
-#include <vector>
+#include <array>
 
 #include "bounding_box.h"
 #include "pose_landmark.h"
 
 class Filter {
-  size_t window_size;
+  static const size_t WINDOW_SIZE = 10;
+
   float alpha;
   float alpha_landmarks;
-  std::vector<BoundingBox> data;
-  std::vector<Landmark> data_landmark;
+
+  // Ring buffers with the latest values, head is the newest one
+  std::array<BoundingBox, WINDOW_SIZE> data;
+  size_t head;
+  size_t size;
+  std::array<Landmark, WINDOW_SIZE> data_landmark;
+  size_t head_landmark;
+  size_t size_landmark;
 
 public:
   Filter();
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Motion-gated idle mode
+ *
+ */
+
+#include "idle_monitor.h"
+
+IdleMonitor::IdleMonitor(const float &idle_timeout, const float &camera_fps)
+    : idle_timeout{static_cast<int64_t>(idle_timeout * 1e6)},
+      idle_divider{std::max(1, static_cast<int>(camera_fps / IDLE_RATE))},
+      idle{false}, last_pose_time{0}, wake_time{0}, wakeups{0},
+      wake_latency{0.0}, samples{}, has_samples{false}, idle_frames{0} {}
+
+bool IdleMonitor::admit_frame(const uint8_t *yuy2, const int &width,
+                              const int &height, const int &stride,
+                              const int64_t &timestamp) {
+  if (!idle)
+    return true;
+
+  if (detect_motion(yuy2, width, height, stride)) {
+    // Timeout starts again from the wake-up
+    last_pose_time = timestamp;
+    wake_time = timestamp;
+    idle = false;
+    has_samples = false;
+    wakeups++;
+    return true;
+  }
+
+  // Low rate detection, for a person entering without enough motion
+  return idle_frames++ % idle_divider == 0;
+}
+
+bool IdleMonitor::detect_motion(const uint8_t *yuy2, const int &width,
+                                const int &height, const int &stride) {
+  // Luma of a pixel x is byte 2x of its YUY2 row
+  size_t num_samples =
+      ((width + GRID_STEP - 1) / GRID_STEP) *
+      ((height + GRID_STEP - 1) / GRID_STEP);
+  if (samples.size() != num_samples) {
+    samples.resize(num_samples);
+    has_samples = false;
+  }
+
+  size_t changed = 0;
+  size_t index = 0;
+  for (int y{0}; y < height; y += GRID_STEP) {
+    const uint8_t *row = yuy2 + y * stride;
+    for (int x{0}; x < width; x += GRID_STEP) {
+      uint8_t luma = row[x * 2];
+      if (std::abs(luma - samples[index]) > MOTION_THRESHOLD)
+        changed++;
+      samples[index++] = luma;
+    }
+  }
+
+  // First frame is only a reference
+  bool motion = has_samples && changed > num_samples * MOTION_RATIO;
+  has_samples = true;
+  return motion;
+}
+
+bool IdleMonitor::update_detection(const bool &pose_found,
+                                   const int64_t &timestamp) {
+  if (!is_enabled())
+    return false;
+
+  if (pose_found) {
+    last_pose_time = timestamp;
+    int64_t wake = wake_time.exchange(0);
+    if (wake > 0)
+      wake_latency = (timestamp - wake) / 1000.0;
+
+    // Found by a low rate detection
+    if (idle) {
+      idle = false;
+      return true;
+    }
+    return false;
+  }
+
+  // Timeout starts from the first result
+  int64_t expected = 0;
+  last_pose_time.compare_exchange_strong(expected, timestamp);
+
+  if (!idle && timestamp - last_pose_time > idle_timeout) {
+    wake_time = 0;
+    idle = true;
+    return true;
+  }
+  return false;
+}
+
+bool IdleMonitor::is_enabled() const { return idle_timeout > 0; }
+
+bool IdleMonitor::is_idle() const { return idle; }
+
+float IdleMonitor::get_idle_rate() const { return IDLE_RATE; }
+
+uint64_t IdleMonitor::get_wakeups() const { return wakeups; }
+
+float IdleMonitor::get_wake_latency() const { return wake_latency; }
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Motion-gated idle mode
+ *
+ * After some time without any pose detected, the station goes idle: pose
+ * detection only runs at a low rate, and every camera frame is checked for
+ * motion with a frame difference on a sparse grid of luma samples read
+ * directly from the YUY2 buffer. The first frame with motion leaves the idle
+ * mode and goes through pose detection, and the time from that frame to the
+ * first detected pose is measured as the wake-up latency.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+class IdleMonitor {
+  static const int GRID_STEP = 8;             // Pixels between samples
+  static const int MOTION_THRESHOLD = 16;     // Luma change of a sample
+  static constexpr float MOTION_RATIO = 0.01; // Of the samples changed
+  static constexpr float IDLE_RATE = 1.0;     // Detections per second
+
+  int64_t idle_timeout; // us, 0 if disabled
+  int idle_divider;     // Camera frames per detection while idle
+
+  std::atomic<bool> idle;
+  std::atomic<int64_t> last_pose_time; // us
+  std::atomic<int64_t> wake_time;      // us, 0 if not measuring a wake-up
+  std::atomic<uint64_t> wakeups;
+  std::atomic<float> wake_latency; // ms
+
+  // Owned by the camera thread
+  std::vector<uint8_t> samples;
+  bool has_samples;
+  uint64_t idle_frames;
+
+  bool detect_motion(const uint8_t *yuy2, const int &width, const int &height,
+                     const int &stride);
+
+public:
+  // Idle after idle_timeout seconds without pose, 0 disables the idle mode
+  IdleMonitor(const float &idle_timeout, const float &camera_fps);
+
+  // Called from the camera thread for every frame while idle, returns true
+  // if the frame must go through pose detection
+  bool admit_frame(const uint8_t *yuy2, const int &width, const int &height,
+                   const int &stride, const int64_t &timestamp);
+
+  // Called with every pose detection result, returns true if the station
+  // went idle or left the idle mode
+  bool update_detection(const bool &pose_found, const int64_t &timestamp);
+
+  bool is_enabled() const;
+  bool is_idle() const;
+  float get_idle_rate() const;
+  uint64_t get_wakeups() const;
+  // Time from the frame that left the idle mode to the first detected pose
+  float get_wake_latency() const;
+};
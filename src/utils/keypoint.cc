@@ -49,7 +49,7 @@ float Keypoint::operator[](const std::string &key) const {
 }
 
 // Distance operator 2D
-float Keypoint::operator^(const Keypoint &kp) {
+float Keypoint::operator^(const Keypoint &kp) const {
   return std::sqrt(std::pow(this->x - kp.x, 2) + std::pow(this->y - kp.y, 2));
 }
 
@@ -66,22 +66,22 @@ Keypoint &Keypoint::operator=(const Keypoint &kp) {
   return *this;
 }
 
-Keypoint Keypoint::operator+(const float &value) {
+Keypoint Keypoint::operator+(const float &value) const {
   Keypoint tmp_kp(this->x + value, this->y + value, this->z + value);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator-(const float &value) {
+Keypoint Keypoint::operator-(const float &value) const {
   Keypoint tmp_kp(this->x - value, this->y - value, this->z - value);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator*(const float &value) {
+Keypoint Keypoint::operator*(const float &value) const {
   Keypoint tmp_kp(this->x * value, this->y * value, this->z * value);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator/(const float &value) {
+Keypoint Keypoint::operator/(const float &value) const {
   Keypoint tmp_kp(this->x / value, this->y / value, this->z / value);
   return tmp_kp;
 }
@@ -118,22 +118,22 @@ Keypoint Keypoint::operator/=(const float &value) {
   return *this;
 }
 
-Keypoint Keypoint::operator+(const Keypoint &kp) {
+Keypoint Keypoint::operator+(const Keypoint &kp) const {
   Keypoint tmp_kp(this->x + kp.x, this->y + kp.y, this->z + kp.z);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator-(const Keypoint &kp) {
+Keypoint Keypoint::operator-(const Keypoint &kp) const {
   Keypoint tmp_kp(this->x - kp.x, this->y - kp.y, this->z - kp.z);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator*(const Keypoint &kp) {
+Keypoint Keypoint::operator*(const Keypoint &kp) const {
   Keypoint tmp_kp(this->x * kp.x, this->y * kp.y, this->z * kp.z);
   return tmp_kp;
 }
 
-Keypoint Keypoint::operator/(const Keypoint &kp) {
+Keypoint Keypoint::operator/(const Keypoint &kp) const {
   Keypoint tmp_kp(this->x / kp.x, this->y / kp.y, this->z / kp.z);
   return tmp_kp;
 }
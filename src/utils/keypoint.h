@@ -29,25 +29,25 @@ public:
   float operator[](const std::string &key) const;
 
   // Distance operator 2D
-  float operator^(const Keypoint &kp);
+  float operator^(const Keypoint &kp) const;
 
   // Assignment operator
   Keypoint &operator=(const Keypoint &kp);
 
-  Keypoint operator+(const float &value);
-  Keypoint operator-(const float &value);
-  Keypoint operator*(const float &value);
-  Keypoint operator/(const float &value);
+  Keypoint operator+(const float &value) const;
+  Keypoint operator-(const float &value) const;
+  Keypoint operator*(const float &value) const;
+  Keypoint operator/(const float &value) const;
 
   Keypoint operator+=(const float &value);
   Keypoint operator-=(const float &value);
   Keypoint operator*=(const float &value);
   Keypoint operator/=(const float &value);
 
-  Keypoint operator+(const Keypoint &kp);
-  Keypoint operator-(const Keypoint &kp);
-  Keypoint operator*(const Keypoint &kp);
-  Keypoint operator/(const Keypoint &kp);
+  Keypoint operator+(const Keypoint &kp) const;
+  Keypoint operator-(const Keypoint &kp) const;
+  Keypoint operator*(const Keypoint &kp) const;
+  Keypoint operator/(const Keypoint &kp) const;
 
   Keypoint operator+=(const Keypoint &kp);
   Keypoint operator-=(const Keypoint &kp);
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Metrics registry
+ *
+ */
+
+#include "metrics.h"
+
+Metrics::Metric::Metric(const std::string &name, const std::string &labels,
+                        const std::string &help, const Type &type)
+    : name{name}, labels{labels}, help{help}, type{type}, value{0.0} {}
+
+void Metrics::Metric::increment(const double &amount) {
+  double current = value.load(std::memory_order_relaxed);
+  while (!value.compare_exchange_weak(current, current + amount,
+                                      std::memory_order_relaxed))
+    ;
+}
+
+void Metrics::Metric::set(const double &value) {
+  this->value.store(value, std::memory_order_relaxed);
+}
+
+double Metrics::Metric::get() const {
+  return value.load(std::memory_order_relaxed);
+}
+
+const std::string &Metrics::Metric::get_name() const { return name; }
+
+const std::string &Metrics::Metric::get_labels() const { return labels; }
+
+const std::string &Metrics::Metric::get_help() const { return help; }
+
+Metrics::Type Metrics::Metric::get_type() const { return type; }
+
+Metrics::Metrics() : metrics{} {}
+
+Metrics::Metric *Metrics::add_counter(const std::string &name,
+                                      const std::string &help,
+                                      const std::string &labels) {
+  metrics.emplace_back(name, labels, help, COUNTER);
+  return &metrics.back();
+}
+
+Metrics::Metric *Metrics::add_gauge(const std::string &name,
+                                    const std::string &help,
+                                    const std::string &labels) {
+  metrics.emplace_back(name, labels, help, GAUGE);
+  return &metrics.back();
+}
+
+std::string Metrics::to_prometheus() const {
+  std::ostringstream out;
+  out << std::setprecision(10);
+  for (size_t i{0}; i < metrics.size(); i++) {
+    const Metric &metric = metrics.at(i);
+
+    // Header is written once per metric name
+    if (i == 0 || metrics.at(i - 1).get_name() != metric.get_name()) {
+      out << "# HELP " << metric.get_name() << " " << metric.get_help()
+          << "\n";
+      out << "# TYPE " << metric.get_name() << " "
+          << (metric.get_type() == COUNTER ? "counter" : "gauge") << "\n";
+    }
+
+    out << metric.get_name();
+    if (!metric.get_labels().empty())
+      out << "{" << metric.get_labels() << "}";
+    out << " " << metric.get() << "\n";
+  }
+  return out.str();
+}
+
+std::string Metrics::to_json() const {
+  std::ostringstream out;
+  out << std::setprecision(10) << "{";
+  for (size_t i{0}; i < metrics.size(); i++) {
+    const Metric &metric = metrics.at(i);
+    if (i > 0)
+      out << ",";
+
+    // Labels are kept in the key, with their quotes escaped
+    out << "\"" << metric.get_name();
+    if (!metric.get_labels().empty()) {
+      out << "{";
+      for (const char &c : metric.get_labels()) {
+        if (c == '"')
+          out << "\\";
+        out << c;
+      }
+      out << "}";
+    }
+    out << "\":" << metric.get();
+  }
+  out << "}";
+  return out.str();
+}
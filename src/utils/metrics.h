@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Metrics registry
+ *
+ * Counters and gauges are registered once at startup and updated lock-free
+ * from any thread. The registry can be rendered in the Prometheus text
+ * exposition format or as a single JSON object.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+class Metrics {
+public:
+  enum Type { COUNTER, GAUGE };
+
+  class Metric {
+    std::string name;
+    std::string labels; // Prometheus labels, e.g. queue="display"
+    std::string help;
+    Type type;
+    std::atomic<double> value;
+
+  public:
+    Metric(const std::string &name, const std::string &labels,
+           const std::string &help, const Type &type);
+
+    void increment(const double &amount = 1.0);
+    void set(const double &value);
+    double get() const;
+
+    const std::string &get_name() const;
+    const std::string &get_labels() const;
+    const std::string &get_help() const;
+    Type get_type() const;
+  };
+
+  Metrics();
+
+  // Metrics sharing a name must be registered one after the other
+  Metric *add_counter(const std::string &name, const std::string &help,
+                      const std::string &labels = "");
+  Metric *add_gauge(const std::string &name, const std::string &help,
+                    const std::string &labels = "");
+
+  std::string to_prometheus() const;
+  std::string to_json() const;
+
+private:
+  // Deque keeps the metrics addresses stable when registering new ones
+  std::deque<Metric> metrics;
+};
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Local HTTP endpoint serving the metrics in Prometheus text format
+ *
+ */
+
+#include "metrics_server.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+MetricsServer::MetricsServer(Metrics *metrics)
+    : metrics{metrics}, service{nullptr} {}
+
+MetricsServer::~MetricsServer() { stop(); }
+
+bool MetricsServer::start(const char *address) {
+  GSocketAddress *socket_address = nullptr;
+  if (strncmp(address, "unix:", 5) == 0) {
+    // Remove the socket left by a previous run
+    unlink(address + 5);
+    socket_address = g_unix_socket_address_new(address + 5);
+  } else {
+    int port = atoi(address);
+    if (port <= 0 || port > 65535) {
+      std::cerr << "Invalid metrics address " << address << "\n";
+      return false;
+    }
+    socket_address = g_inet_socket_address_new_from_string("127.0.0.1", port);
+  }
+
+  GError *error = nullptr;
+  service = g_socket_service_new();
+  if (!g_socket_listener_add_address(
+          G_SOCKET_LISTENER(service), socket_address, G_SOCKET_TYPE_STREAM,
+          G_SOCKET_PROTOCOL_DEFAULT, NULL, NULL, &error)) {
+    std::cerr << "Failed to serve metrics on " << address << ": "
+              << error->message << "\n";
+    g_clear_error(&error);
+    g_object_unref(socket_address);
+    stop();
+    return false;
+  }
+  g_object_unref(socket_address);
+
+  g_signal_connect(service, "incoming", G_CALLBACK(on_incoming), this);
+  g_socket_service_start(service);
+  return true;
+}
+
+void MetricsServer::stop() {
+  if (service == nullptr)
+    return;
+  g_socket_service_stop(service);
+  g_socket_listener_close(G_SOCKET_LISTENER(service));
+  g_object_unref(service);
+  service = nullptr;
+}
+
+gboolean MetricsServer::on_incoming(GSocketService *service,
+                                    GSocketConnection *connection,
+                                    GObject *source_object,
+                                    gpointer user_data) {
+  (void)service;
+  (void)source_object;
+  MetricsServer *server = static_cast<MetricsServer *>(user_data);
+
+  // Do not let a silent client stall the main loop
+  g_socket_set_timeout(g_socket_connection_get_socket(connection), 1);
+
+  // Request is read and ignored
+  char request[1024];
+  GInputStream *input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+  g_input_stream_read(input, request, sizeof(request), NULL, NULL);
+
+  std::string body = server->metrics->to_prometheus();
+  std::string response = "HTTP/1.0 200 OK\r\n"
+                         "Content-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: " +
+                         std::to_string(body.size()) + "\r\n\r\n" + body;
+
+  GOutputStream *output =
+      g_io_stream_get_output_stream(G_IO_STREAM(connection));
+  g_output_stream_write_all(output, response.data(), response.size(), NULL,
+                            NULL, NULL);
+  g_io_stream_close(G_IO_STREAM(connection), NULL, NULL);
+  return TRUE;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Local HTTP endpoint serving the metrics in Prometheus text format
+ *
+ * The server is driven by the default GLib main context, every request gets
+ * the whole registry whatever the requested path is.
+ *
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include "metrics.h"
+
+class MetricsServer {
+  Metrics *metrics;
+  GSocketService *service;
+
+  static gboolean on_incoming(GSocketService *service,
+                              GSocketConnection *connection,
+                              GObject *source_object, gpointer user_data);
+
+public:
+  MetricsServer(Metrics *metrics);
+  ~MetricsServer();
+
+  // Address is a TCP port on the loopback interface or unix:<path>
+  bool start(const char *address);
+  void stop();
+};
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Landmark model cascade
+ *
+ */
+
+#include "model_cascade.h"
+
+ModelCascade::ModelCascade()
+    : model{ACCURATE}, accurate_fits{true}, hard_frames{0},
+      previous_landmark{}, has_previous_landmark{false} {}
+
+void ModelCascade::update_frame(const Landmark &landmark, const float &score,
+                                const bool &decoded,
+                                const float &class_margin) {
+  bool hard = !decoded || score < HARD_SCORE ||
+              class_margin < AMBIGUOUS_MARGIN;
+  if (hard)
+    hard_frames = HARD_FRAMES;
+  else if (hard_frames > 0)
+    hard_frames--;
+
+  bool is_static = false;
+  if (decoded) {
+    is_static = has_previous_landmark && get_motion(landmark) < STATIC_MOTION;
+    previous_landmark = landmark;
+    has_previous_landmark = true;
+  } else {
+    has_previous_landmark = false;
+  }
+
+  if (hard_frames > 0)
+    model = ACCURATE;
+  else if (is_static || !accurate_fits)
+    model = FAST;
+  else
+    model = ACCURATE;
+}
+
+void ModelCascade::update_budget(const float &accurate_time,
+                                 const float &other_time,
+                                 const float &period) {
+  accurate_fits = (accurate_time + other_time) <= MAX_LOAD * period;
+}
+
+ModelCascade::Model ModelCascade::get_model() const { return model; }
+
+float ModelCascade::get_motion(const Landmark &landmark) const {
+  // Mean displacement of the keypoints, normalized to the pose region
+  float motion = 0.0;
+  for (size_t i{0}; i < 33; i++) {
+    motion += std::abs(landmark(i)["x"] - previous_landmark(i)["x"]) +
+              std::abs(landmark(i)["y"] - previous_landmark(i)["y"]);
+  }
+  return motion / 33;
+}
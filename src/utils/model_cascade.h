@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Landmark model cascade
+ *
+ * Chooses between a fast and an accurate pose landmark model for every
+ * frame. The accurate model is held for a few frames after a hard frame, a
+ * landmark with a low score or a classification ambiguous between two pose
+ * classes. Otherwise, the fast model runs while the pose is static or while
+ * the accurate model does not fit in the frame period, and the accurate one
+ * runs when it does.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+
+#include "pose_landmark.h"
+
+class ModelCascade {
+public:
+  enum Model { FAST = 0, ACCURATE = 1 };
+
+private:
+  static constexpr float HARD_SCORE = 0.9;
+  static constexpr float AMBIGUOUS_MARGIN = 0.2; // Of the top confidence
+  static constexpr float STATIC_MOTION = 0.01;   // Of the pose region size
+  static constexpr float MAX_LOAD = 0.9;         // Of the frame period
+  static const size_t HARD_FRAMES = 5;
+
+  std::atomic<Model> model;
+  std::atomic<bool> accurate_fits;
+  size_t hard_frames;
+
+  Landmark previous_landmark;
+  bool has_previous_landmark;
+
+  float get_motion(const Landmark &landmark) const;
+
+public:
+  ModelCascade();
+
+  // Called with every landmark result: its score, whether it was decoded,
+  // and the margin between the two most confident pose classes relative to
+  // the top one. Chooses the model of the next frame.
+  void update_frame(const Landmark &landmark, const float &score,
+                    const bool &decoded, const float &class_margin);
+
+  // Called periodically with the average inference time (ms) of the accurate
+  // model and of the other models run for a frame, and the frame period (ms)
+  void update_budget(const float &accurate_time, const float &other_time,
+                     const float &period);
+
+  Model get_model() const;
+};
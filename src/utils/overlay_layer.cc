@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Cached overlay layer
+ *
+ */
+
+#include "overlay_layer.h"
+
+OverlayLayer::OverlayLayer()
+    : key{}, rectangle{nullptr}, rasterized{0}, buffer{nullptr}, map{},
+      surface{nullptr}, x{0}, y{0}, width{0}, height{0} {}
+
+OverlayLayer::~OverlayLayer() { clear(); }
+
+bool OverlayLayer::is_stale(const std::string &contents) const {
+  return rectangle == nullptr || contents != key;
+}
+
+cairo_t *OverlayLayer::begin(const std::string &contents, const int &x,
+                             const int &y, const int &width,
+                             const int &height) {
+  key = contents;
+  this->x = x;
+  this->y = y;
+  this->width = width;
+  this->height = height;
+
+  // Overlay rectangles are ARGB with premultiplied alpha, as cairo draws
+  buffer = gst_buffer_new_allocate(NULL, width * height * 4, NULL);
+  gst_buffer_add_video_meta(buffer, GST_VIDEO_FRAME_FLAG_NONE,
+                            GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width,
+                            height);
+  gst_buffer_map(buffer, &map, GST_MAP_WRITE);
+  memset(map.data, 0, map.size);
+  surface = cairo_image_surface_create_for_data(
+      map.data, CAIRO_FORMAT_ARGB32, width, height, width * 4);
+
+  cairo_t *cr = cairo_create(surface);
+  cairo_translate(cr, -x, -y);
+  return cr;
+}
+
+void OverlayLayer::end(cairo_t *cr) {
+  cairo_destroy(cr);
+  cairo_surface_flush(surface);
+  cairo_surface_destroy(surface);
+  surface = nullptr;
+  gst_buffer_unmap(buffer, &map);
+
+  if (rectangle != nullptr)
+    gst_video_overlay_rectangle_unref(rectangle);
+  rectangle = gst_video_overlay_rectangle_new_raw(
+      buffer, x, y, width, height,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
+  gst_buffer_unref(buffer);
+  buffer = nullptr;
+  rasterized++;
+}
+
+void OverlayLayer::clear() {
+  key.clear();
+  if (rectangle != nullptr) {
+    gst_video_overlay_rectangle_unref(rectangle);
+    rectangle = nullptr;
+  }
+}
+
+GstVideoOverlayRectangle *OverlayLayer::get_rectangle() const {
+  return rectangle;
+}
+
+uint64_t OverlayLayer::get_rasterized() const { return rasterized; }
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Cached overlay layer
+ *
+ * A layer of the display overlay (e.g. the text or the skeleton) rasterized
+ * with cairo into a small ARGB GstVideoOverlayRectangle. The rectangle is
+ * kept as long as the contents of the layer do not change, so static
+ * contents are rasterized once and only attached to the next frames, to be
+ * blended by the sink or by the compositor.
+ *
+ * Contents are identified by a key built by the caller from everything that
+ * is drawn. Rectangles handed to a composition may still be in use
+ * downstream, so a change always rasterizes into a new rectangle.
+ *
+ */
+
+#pragma once
+
+#include <cairo/cairo.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <cstring>
+#include <string>
+
+class OverlayLayer {
+  std::string key; // Contents of the current rectangle
+  GstVideoOverlayRectangle *rectangle;
+  uint64_t rasterized;
+
+  // Rasterization in progress
+  GstBuffer *buffer;
+  GstMapInfo map;
+  cairo_surface_t *surface;
+  int x;
+  int y;
+  int width;
+  int height;
+
+public:
+  OverlayLayer();
+  ~OverlayLayer();
+
+  // True if the contents differ from the current rectangle
+  bool is_stale(const std::string &contents) const;
+
+  // Start rasterizing the contents in an area of the frame. Drawing uses
+  // frame coordinates and is clipped to the area.
+  cairo_t *begin(const std::string &contents, const int &x, const int &y,
+                 const int &width, const int &height);
+  void end(cairo_t *cr);
+
+  // Remove the rectangle, e.g. when there is nothing to draw
+  void clear();
+
+  // Current rectangle, nullptr if the layer is empty
+  GstVideoOverlayRectangle *get_rectangle() const;
+  uint64_t get_rasterized() const;
+};
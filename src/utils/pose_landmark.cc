@@ -16,7 +16,8 @@ Landmark::Landmark()
       right_elbow{}, left_wrist{}, right_wrist{}, left_pinky{}, right_pinky{},
       left_index{}, right_index{}, left_thumb{}, right_thumb{}, left_hip{},
       right_hip{}, left_knee{}, right_knee{}, left_ankle{},
-      right_ankle{}, left_heel{}, right_heel{}, left_foot{}, right_foot{} {}
+      right_ankle{}, left_heel{}, right_heel{}, left_foot{}, right_foot{},
+      visibility{}, presence{} {}
 
 // Assignment operator
 Landmark &Landmark::operator=(const Landmark &landmark) {
@@ -56,6 +57,7 @@ Landmark &Landmark::operator=(const Landmark &landmark) {
   this->right_heel = landmark.right_heel;
   this->left_foot = landmark.left_foot;
   this->right_foot = landmark.right_foot;
+  set_scores(landmark);
 
   return *this;
 }
@@ -305,3 +307,39 @@ Landmark Landmark::operator+=(const float &factor) {
 
   return *this;
 }
+
+float Landmark::get_visibility(const int &index) const {
+  return visibility[index];
+}
+
+float Landmark::get_presence(const int &index) const { return presence[index]; }
+
+void Landmark::set_scores(const int &index, const float &visibility,
+                          const float &presence) {
+  this->visibility[index] = visibility;
+  this->presence[index] = presence;
+}
+
+void Landmark::set_scores(const Landmark &landmark) {
+  for (size_t i{0}; i < 33; i++) {
+    visibility[i] = landmark.visibility[i];
+    presence[i] = landmark.presence[i];
+  }
+}
+
+int Landmark::get_index(const std::string &key) {
+  static const char *const names[33] = {
+      "nose", "left_eye_inner", "left_eye", "left_eye_outer", "right_eye_inner",
+      "right_eye", "right_eye_outer", "left_ear", "right_ear", "left_mouth",
+      "right_mouth", "left_shoulder", "right_shoulder", "left_elbow",
+      "right_elbow", "left_wrist", "right_wrist", "left_pinky", "right_pinky",
+      "left_index", "right_index", "left_thumb", "right_thumb", "left_hip",
+      "right_hip", "left_knee", "right_knee", "left_ankle", "right_ankle",
+      "left_heel", "right_heel", "left_foot", "right_foot"};
+
+  for (int i{0}; i < 33; i++) {
+    if (key == names[i])
+      return i;
+  }
+  return -1;
+}
@@ -45,8 +45,13 @@ class Landmark {
   Keypoint left_foot;
   Keypoint right_foot;
 
+  // Visibility and presence scores of each keypoint, in [0, 1]
+  float visibility[33];
+  float presence[33];
+
 public:
   Landmark();
+  Landmark(const Landmark &landmark) = default;
 
   // Assignment operators
   Landmark &operator=(const Landmark &landmark);
@@ -55,6 +60,16 @@ public:
   // Getters
   Keypoint operator()(const int &index) const;
   Keypoint operator[](const std::string &key);
+  float get_visibility(const int &index) const;
+  float get_presence(const int &index) const;
+
+  void set_scores(const int &index, const float &visibility,
+                  const float &presence);
+  // Copy the visibility and presence scores of all keypoints
+  void set_scores(const Landmark &landmark);
+
+  // Index of a keypoint from its name, -1 when unknown
+  static int get_index(const std::string &key);
 
   Landmark operator*(const float &factor);
   Landmark operator/(const Landmark &landmark);
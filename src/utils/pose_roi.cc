@@ -0,0 +1,48 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pose region of interest
+ *
+ */
+
+#include "pose_roi.h"
+
+bool get_pose_roi(const std::vector<PoseDetection> &detections,
+                  const Keypoint &padded_size, const int &width,
+                  const int &height, BoundingBox &roi) {
+  Keypoint center(width / 2, height / 2);
+
+  PoseDetection pose;
+  float min_distance = width;
+  int index{-1};
+
+  // Get closest pose to center of frame and only process for one person
+  for (size_t i{0}; i < detections.size(); i++) {
+    pose = detections.at(i);
+    float distance = (pose.get_mid_hip_center() * padded_size) ^ center;
+    if (distance < min_distance) {
+      min_distance = distance;
+      index = i;
+    }
+  }
+  if (index < 0)
+    return false;
+
+  // Detections are normalized to the model input, whose aspect ratio differs
+  // from the padded frame when the frame is stretched, so the radius of the
+  // body is taken in pixels
+  pose = detections.at(index);
+  Keypoint mid_hip_center = pose.get_mid_hip_center() * padded_size;
+  float radius =
+      (pose.get_full_body_size_rotation() * padded_size) ^ mid_hip_center;
+
+  roi = BoundingBox(mid_hip_center - radius, mid_hip_center + radius);
+  return true;
+}
+
+bool is_roi_inside(const BoundingBox &roi, const int &width,
+                   const int &height) {
+  return roi("xmin") > 0 && roi("ymin") > 0 && roi("xmax") < width &&
+         roi("ymax") < height;
+}
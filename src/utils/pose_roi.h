@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pose region of interest
+ *
+ * The pose landmark model runs on a square region around the body of the
+ * detected person closest to the center of the frame. Its size is given by
+ * the distance between the mid hip center and the full body size & rotation
+ * keypoints of the pose detection.
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "bounding_box.h"
+#include "pose_detection.h"
+
+// Region of the pose closest to the frame center, in frame pixels.
+// Detections are normalized to the frame as fed to the pose detection model,
+// padded_size is the size of that frame in pixels. Returns false if no pose
+// was detected.
+bool get_pose_roi(const std::vector<PoseDetection> &detections,
+                  const Keypoint &padded_size, const int &width,
+                  const int &height, BoundingBox &roi);
+
+// Whether the region lies strictly inside the frame and can be cropped
+bool is_roi_inside(const BoundingBox &roi, const int &width,
+                   const int &height);
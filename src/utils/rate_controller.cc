@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Adaptive inference rate controller
+ *
+ */
+
+#include "rate_controller.h"
+
+const int RateController::DIVIDERS[NUM_LEVELS] = {1, 2, 3};
+
+RateController::RateController(const float &camera_fps,
+                               const float &latency_budget)
+    : camera_fps{camera_fps}, latency_budget{latency_budget}, adaptive{true},
+      level{0}, degrade_count{0}, upgrade_count{0}, reason{"start"},
+      detection_frames{0}, landmark_frames{0} {}
+
+RateController::RateController(const float &camera_fps,
+                               const float &latency_budget, const float &rate)
+    : RateController(camera_fps, latency_budget) {
+  adaptive = false;
+  size_t closest = 0;
+  for (size_t i{1}; i < NUM_LEVELS; i++) {
+    if (std::abs(get_rate(i) - rate) < std::abs(get_rate(closest) - rate))
+      closest = i;
+  }
+  level = closest;
+  reason = "fixed";
+}
+
+bool RateController::update(const float &inference_time, const float &latency,
+                            const float &drop_ratio) {
+  if (!adaptive)
+    return false;
+
+  size_t current = level;
+  float load = inference_time * get_rate(current) / 1000.0;
+
+  char message[128];
+  bool overloaded = true;
+  if (load > MAX_LOAD) {
+    snprintf(message, sizeof(message), "load %.2f > %.2f", load, MAX_LOAD);
+  } else if (latency > latency_budget) {
+    snprintf(message, sizeof(message), "latency %.1f ms > %.1f ms", latency,
+             latency_budget);
+  } else if (drop_ratio > MAX_DROP_RATIO) {
+    snprintf(message, sizeof(message), "drop ratio %.2f > %.2f", drop_ratio,
+             MAX_DROP_RATIO);
+  } else {
+    overloaded = false;
+  }
+
+  if (overloaded) {
+    upgrade_count = 0;
+    if (++degrade_count >= DEGRADE_UPDATES && current + 1 < NUM_LEVELS) {
+      degrade_count = 0;
+      level = current + 1;
+      reason = message;
+      return true;
+    }
+    return false;
+  }
+  degrade_count = 0;
+
+  if (current == 0)
+    return false;
+
+  // Upgrade only if the higher rate keeps some headroom
+  float next_load = inference_time * get_rate(current - 1) / 1000.0;
+  if (next_load < MAX_UPGRADE_LOAD &&
+      latency < latency_budget * UPGRADE_LATENCY_RATIO && drop_ratio == 0.0) {
+    if (++upgrade_count >= UPGRADE_UPDATES) {
+      upgrade_count = 0;
+      level = current - 1;
+      snprintf(message, sizeof(message), "load at %.0f Hz %.2f < %.2f",
+               get_rate(current - 1), next_load, MAX_UPGRADE_LOAD);
+      reason = message;
+      return true;
+    }
+  } else {
+    upgrade_count = 0;
+  }
+  return false;
+}
+
+bool RateController::admit_detection() {
+  return detection_frames++ % DIVIDERS[level] == 0;
+}
+
+bool RateController::admit_landmark() {
+  return landmark_frames++ % DIVIDERS[level] == 0;
+}
+
+float RateController::get_rate(const size_t &level) const {
+  return camera_fps / DIVIDERS[level];
+}
+
+float RateController::get_rate() const { return get_rate(level); }
+
+bool RateController::is_adaptive() const { return adaptive; }
+
+const std::string &RateController::get_reason() const { return reason; }
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Adaptive inference rate controller
+ *
+ * Chooses how often the detection and landmark models run among fixed
+ * fractions of the camera frame rate (e.g. 30/15/10 Hz). The rate is lowered
+ * when the NPU load, the end-to-end latency or the dropped frames exceed
+ * their limits, and raised back only once the next rate has kept enough
+ * headroom for several updates, so the rate does not oscillate.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+class RateController {
+  static const size_t NUM_LEVELS = 3;
+  static const int DIVIDERS[NUM_LEVELS]; // Camera frames per inference
+
+  // Load is the fraction of the frame period spent in inference
+  static constexpr float MAX_LOAD = 0.9;
+  static constexpr float MAX_UPGRADE_LOAD = 0.7;
+  static constexpr float MAX_DROP_RATIO = 0.05;
+  static constexpr float UPGRADE_LATENCY_RATIO = 0.8;
+  static const int DEGRADE_UPDATES = 2;
+  static const int UPGRADE_UPDATES = 5;
+
+  float camera_fps;
+  float latency_budget; // ms
+  bool adaptive;
+
+  std::atomic<size_t> level;
+  int degrade_count;
+  int upgrade_count;
+  std::string reason;
+
+  std::atomic<uint64_t> detection_frames;
+  std::atomic<uint64_t> landmark_frames;
+
+  float get_rate(const size_t &level) const;
+
+public:
+  // Adaptive controller starting at the camera frame rate
+  RateController(const float &camera_fps, const float &latency_budget);
+  // Fixed rate, rounded to the closest supported one
+  RateController(const float &camera_fps, const float &latency_budget,
+                 const float &rate);
+
+  // Called periodically with the average inference time of a frame (ms),
+  // the end-to-end latency (ms) and the ratio of frames dropped since the
+  // previous update. Returns true if the rate changed.
+  bool update(const float &inference_time, const float &latency,
+              const float &drop_ratio);
+
+  // Called from the streaming threads for every camera frame
+  bool admit_detection();
+  bool admit_landmark();
+
+  float get_rate() const;
+  bool is_adaptive() const;
+  // Reason of the latest rate change
+  const std::string &get_reason() const;
+};
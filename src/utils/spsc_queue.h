@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Bounded lock-free single-producer/single-consumer queue
+ *
+ * One thread may call push() and one other thread may call pop(). Storage is
+ * allocated once, so neither side allocates or blocks. push() fails when the
+ * queue is full, leaving the drop policy to the caller.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity> class SpscQueue {
+  // One slot is kept empty to tell a full queue from an empty one
+  std::array<T, Capacity + 1> buffer;
+  std::atomic<size_t> head; // Next slot to read (consumer)
+  std::atomic<size_t> tail; // Next slot to write (producer)
+
+  static size_t next(const size_t &index) {
+    return (index + 1) % (Capacity + 1);
+  }
+
+public:
+  SpscQueue() : buffer{}, head{0}, tail{0} {}
+
+  bool push(const T &item) {
+    size_t current_tail = tail.load(std::memory_order_relaxed);
+    size_t next_tail = next(current_tail);
+    if (next_tail == head.load(std::memory_order_acquire))
+      return false;
+
+    buffer[current_tail] = item;
+    tail.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &item) {
+    size_t current_head = head.load(std::memory_order_relaxed);
+    if (current_head == tail.load(std::memory_order_acquire))
+      return false;
+
+    item = buffer[current_head];
+    head.store(next(current_head), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head.load(std::memory_order_acquire) ==
+           tail.load(std::memory_order_acquire);
+  }
+};
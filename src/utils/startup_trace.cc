@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Startup trace
+ *
+ */
+
+#include "startup_trace.h"
+
+StartupTrace::StartupTrace()
+    : start{std::chrono::steady_clock::now()}, phases{}, events{},
+      num_events{0} {
+  phases.reserve(16);
+}
+
+double StartupTrace::elapsed() const {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+size_t StartupTrace::begin(const char *name) {
+  std::lock_guard<std::mutex> lock(mutex);
+  phases.push_back({name, elapsed(), -1.0});
+  return phases.size() - 1;
+}
+
+void StartupTrace::end(const size_t &phase) {
+  std::lock_guard<std::mutex> lock(mutex);
+  phases.at(phase).end = elapsed();
+}
+
+bool StartupTrace::mark(const char *name) {
+  // Fast path of the events already recorded
+  size_t recorded = num_events.load(std::memory_order_acquire);
+  for (size_t i{0}; i < recorded; i++) {
+    if (events[i].name == name)
+      return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  recorded = num_events.load(std::memory_order_relaxed);
+  for (size_t i{0}; i < recorded; i++) {
+    if (strcmp(events[i].name, name) == 0)
+      return false;
+  }
+  if (recorded == MAX_EVENTS)
+    return false;
+
+  double time = elapsed();
+  events[recorded] = {name, time};
+  num_events.store(recorded + 1, std::memory_order_release);
+
+  // Formatted apart to keep the flags of std::cout
+  std::ostringstream str;
+  str << "[startup] " << name << " at " << std::fixed << std::setprecision(1)
+      << time << " ms\n";
+  std::cout << str.str();
+  return true;
+}
+
+void StartupTrace::report() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::ostringstream str;
+  str << std::fixed << std::setprecision(1);
+  str << "[startup] " << std::left << std::setw(28) << "phase" << std::right
+      << std::setw(11) << "begin ms" << std::setw(11) << "end ms"
+      << std::setw(11) << "duration"
+      << "\n";
+  for (size_t i{0}; i < phases.size(); i++) {
+    const Phase &phase = phases.at(i);
+    str << "[startup] " << std::left << std::setw(28) << phase.name
+        << std::right << std::setw(11) << phase.begin << std::setw(11)
+        << phase.end << std::setw(11) << (phase.end - phase.begin) << "\n";
+  }
+  size_t recorded = num_events.load(std::memory_order_relaxed);
+  for (size_t i{0}; i < recorded; i++) {
+    str << "[startup] " << std::left << std::setw(28) << events[i].name
+        << std::right << std::setw(11) << events[i].time << "\n";
+  }
+  std::cout << str.str();
+}
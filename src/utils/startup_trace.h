@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Startup trace
+ *
+ * Records the duration of the startup phases and the time of the first
+ * occurrence of runtime events (first detection, first repetition...),
+ * relative to the creation of the trace. Phases may run on several threads.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+class StartupTrace {
+  struct Phase {
+    const char *name;
+    double begin; // ms
+    double end;   // ms, negative while running
+  };
+
+  struct Event {
+    const char *name;
+    double time; // ms
+  };
+
+  // Events are only appended, and read without lock up to num_events
+  static const size_t MAX_EVENTS = 16;
+
+  std::chrono::steady_clock::time_point start;
+  std::mutex mutex;
+  std::vector<Phase> phases;
+  Event events[MAX_EVENTS];
+  std::atomic<size_t> num_events;
+
+  double elapsed() const;
+
+public:
+  StartupTrace();
+
+  // Start a phase and return its ID to end it
+  size_t begin(const char *name);
+  void end(const size_t &phase);
+
+  // Record the first occurrence of an event, return true if it was the first.
+  // Called on every frame: once recorded, an event is found without lock
+  // from the address of its name, so callers pass a string literal.
+  bool mark(const char *name);
+
+  void report();
+};
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tensor specifications from NNStreamer caps
+ *
+ */
+
+#include "tensor_caps.h"
+
+bool get_tensor_specs(const GstCaps *caps, std::vector<TensorSpec> &tensors) {
+  GstTensorsConfig config;
+  gst_tensors_config_init(&config);
+  bool valid = gst_tensors_config_from_structure(
+      &config, gst_caps_get_structure(caps, 0));
+
+  tensors.clear();
+  if (valid)
+    get_tensor_specs(config, tensors);
+  gst_tensors_config_free(&config);
+  return valid;
+}
+
+void get_tensor_specs(const GstTensorsConfig &config,
+                      std::vector<TensorSpec> &tensors) {
+  tensors.clear();
+  for (guint i{0}; i < config.info.num_tensors; i++) {
+    GstTensorInfo *info = gst_tensors_info_get_nth_info(
+        const_cast<GstTensorsInfo *>(&config.info), i);
+    TensorSpec tensor;
+    tensor.name = (info->name != NULL) ? info->name : "";
+    tensor.is_float = (info->type == _NNS_FLOAT32);
+    tensor.bytes = gst_tensor_info_get_size(info);
+    for (guint j{0}; j < NNS_TENSOR_RANK_LIMIT && info->dimension[j] > 0; j++)
+      tensor.dims.push_back(info->dimension[j]);
+    tensors.push_back(tensor);
+  }
+}
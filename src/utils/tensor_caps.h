@@ -0,0 +1,23 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tensor specifications from NNStreamer caps
+ *
+ */
+
+#pragma once
+
+#include <gst/gst.h>
+#include <nnstreamer/nnstreamer_plugin_api.h>
+
+#include <vector>
+
+#include "tensor_spec.h"
+
+// Read the tensors described by other/tensors caps, returns false if the caps
+// are not valid tensor caps
+bool get_tensor_specs(const GstCaps *caps, std::vector<TensorSpec> &tensors);
+// Read the tensors of a negotiated tensors configuration
+void get_tensor_specs(const GstTensorsConfig &config,
+                      std::vector<TensorSpec> &tensors);
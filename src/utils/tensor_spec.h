@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shape and type of a model tensor
+ *
+ * Filled from the tensors info negotiated by NNStreamer, so the interpreters
+ * can find their tensors by shape instead of assuming a given model.
+ * Dimensions follow the NNStreamer order, innermost first: a TFLite tensor
+ * of shape [1, 2254, 12] has the dimensions {12, 2254, 1}.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TensorSpec {
+  std::string name;
+  std::vector<uint32_t> dims;
+  bool is_float; // float32 elements
+  size_t bytes;   // Size of the tensor data
+
+  // Total number of elements
+  size_t size() const {
+    size_t count = 1;
+    for (size_t i{0}; i < dims.size(); i++)
+      count *= dims.at(i);
+    return count;
+  }
+
+  // Dimension at index, 1 beyond the rank of the tensor
+  uint32_t dim(const size_t &index) const {
+    return (index < dims.size()) ? dims.at(index) : 1;
+  }
+};
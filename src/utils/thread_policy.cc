@@ -0,0 +1,165 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Thread policy of the processing stages
+ *
+ */
+
+#include "thread_policy.h"
+
+ThreadPolicy::ThreadPolicy() : rules{}, threads{} {}
+
+ThreadPolicy::ThreadPolicy(const char *policy_file) : rules{}, threads{} {
+  std::ifstream file_in;
+  std::string line;
+
+  file_in.open(policy_file, std::ios::in);
+  if (!file_in.is_open()) {
+    std::cerr << "Failed to open " << policy_file << "!\n";
+    exit(-1);
+  }
+
+  while (getline(file_in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    size_t equal = line.find('=');
+    if (equal == std::string::npos || equal == 0) {
+      std::cerr << "Malformed thread policy: " << line << "\n";
+      exit(-1);
+    }
+
+    Rule rule;
+    rule.stage = line.substr(0, equal);
+    rule.priority = 0;
+
+    std::string value = line.substr(equal + 1);
+    try {
+      size_t colon = value.find(':');
+      if (colon != std::string::npos) {
+        rule.priority = std::stoi(value.substr(colon + 1));
+        value = value.substr(0, colon);
+        if (rule.priority < 1 || rule.priority > 99) {
+          std::cerr << "Invalid SCHED_FIFO priority: " << line << "\n";
+          exit(-1);
+        }
+      }
+      if (!parse_cpus(value, rule.cpus)) {
+        std::cerr << "Malformed thread policy: " << line << "\n";
+        exit(-1);
+      }
+    } catch (const std::exception &) {
+      std::cerr << "Malformed thread policy: " << line << "\n";
+      exit(-1);
+    }
+    if (CPU_COUNT(&rule.cpus) == 0) {
+      std::cerr << "No cores in thread policy: " << line << "\n";
+      exit(-1);
+    }
+    rules.push_back(rule);
+  }
+  file_in.close();
+}
+
+bool ThreadPolicy::parse_cpus(const std::string &cpus, cpu_set_t &set) {
+  std::string range;
+  std::stringstream str(cpus);
+
+  CPU_ZERO(&set);
+  while (getline(str, range, ',')) {
+    size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first
+                                           : std::stoi(range.substr(dash + 1));
+    if (first < 0 || first > last || last >= CPU_SETSIZE)
+      return false;
+    for (int cpu = first; cpu <= last; cpu++)
+      CPU_SET(cpu, &set);
+  }
+  return true;
+}
+
+double ThreadPolicy::get_cpu_time(const clockid_t &clock) {
+  struct timespec time;
+  if (clock_gettime(clock, &time) != 0)
+    return 0.0;
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+void ThreadPolicy::enter(const std::string &stage) {
+  pthread_t thread = pthread_self();
+
+  for (size_t i{0}; i < rules.size(); i++) {
+    const Rule &rule = rules.at(i);
+    if (rule.stage != stage)
+      continue;
+
+    int error = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &rule.cpus);
+    if (error != 0) {
+      std::cerr << "Failed to pin " << stage << ": " << strerror(error)
+                << "\n";
+    }
+
+    if (rule.priority > 0) {
+      struct sched_param param;
+      param.sched_priority = rule.priority;
+      error = pthread_setschedparam(thread, SCHED_FIFO, &param);
+      if (error != 0) {
+        std::cerr << "Failed to set SCHED_FIFO priority of " << stage << ": "
+                  << strerror(error) << "\n";
+      }
+    }
+  }
+
+  ThreadRecord record;
+  record.stage = stage;
+  record.thread = thread;
+  record.running = true;
+  record.cpu_time = 0.0;
+  if (pthread_getcpuclockid(thread, &record.clock) != 0)
+    record.clock = CLOCK_THREAD_CPUTIME_ID;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  threads.push_back(record);
+}
+
+void ThreadPolicy::leave() {
+  pthread_t thread = pthread_self();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (size_t i{0}; i < threads.size(); i++) {
+    ThreadRecord &record = threads.at(i);
+    if (record.running && pthread_equal(record.thread, thread)) {
+      record.cpu_time = get_cpu_time(CLOCK_THREAD_CPUTIME_ID);
+      record.running = false;
+    }
+  }
+}
+
+void ThreadPolicy::report() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::cout << "Thread CPU time:\n";
+  for (size_t i{0}; i < threads.size(); i++) {
+    ThreadRecord &record = threads.at(i);
+    double cpu_time =
+        record.running ? get_cpu_time(record.clock) : record.cpu_time;
+
+    // Report the cores the thread actually runs on
+    std::string cpus = "-";
+    cpu_set_t set;
+    if (record.running && pthread_getaffinity_np(record.thread,
+                                                 sizeof(cpu_set_t),
+                                                 &set) == 0) {
+      cpus.clear();
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set))
+          cpus += (cpus.empty() ? "" : ",") + std::to_string(cpu);
+      }
+    }
+
+    std::cout << "  " << std::left << std::setw(24) << record.stage
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << cpu_time << " s  cores " << cpus << "\n";
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Thread policy of the processing stages
+ *
+ * Pins the threads of named stages to a set of cores and optionally runs
+ * them with a SCHED_FIFO priority. A thread applies the policy of its stage
+ * to itself when it starts, and its CPU time is recorded when it stops.
+ * Policies are loaded from a file with one stage per line:
+ *
+ *    stage=cpus[:priority]
+ *
+ * where cpus is a list of cores and ranges (e.g. 2,3 or 0-1) and priority is
+ * the SCHED_FIFO priority (1-99). Empty lines and lines starting with '#' are
+ * ignored. Threads of stages without policy are only recorded.
+ *
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class ThreadPolicy {
+  struct Rule {
+    std::string stage;
+    cpu_set_t cpus;
+    int priority; // 0 keeps the default scheduling policy
+  };
+
+  struct ThreadRecord {
+    std::string stage;
+    pthread_t thread;
+    clockid_t clock;
+    bool running;
+    double cpu_time; // s, set when the thread stops
+  };
+
+  std::vector<Rule> rules;
+  std::mutex mutex;
+  std::vector<ThreadRecord> threads;
+
+  // Returns false for negative cores and decreasing ranges
+  static bool parse_cpus(const std::string &cpus, cpu_set_t &set);
+  static double get_cpu_time(const clockid_t &clock);
+
+public:
+  // No policy, threads are only recorded
+  ThreadPolicy();
+  ThreadPolicy(const char *policy_file);
+
+  // Called by the thread of a stage when it starts and stops
+  void enter(const std::string &stage);
+  void leave();
+
+  // Print the CPU time of every recorded thread
+  void report();
+};
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Persistent pool of worker threads
+ *
+ */
+
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(const size_t &num_threads)
+    : threads{}, task{nullptr}, context{nullptr}, generation{0}, pending{0},
+      running{true} {
+  for (size_t i{1}; i < num_threads; i++)
+    threads.push_back(std::thread(&WorkerPool::worker, this, i));
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+  start_condition.notify_all();
+  for (size_t i{0}; i < threads.size(); i++)
+    threads.at(i).join();
+}
+
+void WorkerPool::run(Task task, void *context) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = task;
+    this->context = context;
+    this->pending = threads.size();
+    this->generation++;
+  }
+  start_condition.notify_all();
+
+  // Calling thread takes the first slot
+  task(context, 0, size());
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done_condition.wait(lock, [this] { return pending == 0; });
+}
+
+size_t WorkerPool::size() const { return threads.size() + 1; }
+
+void WorkerPool::worker(const size_t index) {
+  uint64_t last_generation = 0;
+
+  while (true) {
+    Task current_task;
+    void *current_context;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start_condition.wait(lock, [this, last_generation] {
+        return !running || generation != last_generation;
+      });
+      if (!running)
+        return;
+      last_generation = generation;
+      current_task = task;
+      current_context = context;
+    }
+
+    current_task(current_context, index, size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0)
+      done_condition.notify_one();
+  }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Persistent pool of worker threads
+ *
+ * The threads are created once and sleep between jobs. run() executes a task
+ * once per pool slot, slot 0 on the calling thread and the others on the
+ * workers, and returns when all of them are done. Tasks are plain function
+ * pointers with a context, so dispatching a job does not allocate.
+ *
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+  // Task receives the slot index and the number of slots
+  typedef void (*Task)(void *context, const size_t &index, const size_t &count);
+
+  // Number of slots, including the calling thread
+  WorkerPool(const size_t &num_threads);
+  ~WorkerPool();
+
+  void run(Task task, void *context);
+  size_t size() const;
+
+private:
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start_condition;
+  std::condition_variable done_condition;
+
+  Task task;
+  void *context;
+  uint64_t generation; // Incremented for every job
+  size_t pending;      // Workers still running the current job
+  bool running;
+
+  void worker(const size_t index);
+};
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Heap allocations of the inference path
+ *
+ * operator new is replaced to count the allocations made while 1000 frames
+ * are replayed through the code run per frame outside of GStreamer: pose
+ * detection decoding and NMS, pose region and filters, landmark decoding,
+ * pose embedding, k-NN classification, EMA smoothing and repetition
+ * counters. Landmarks are the pose samples of the embeddings file, and some
+ * frames are below the landmark score threshold to run the frames without
+ * pose. The steady state must not allocate.
+ *
+ *    allocation_test pose_embeddings.csv
+ *
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "classifier/exercise_engine.h"
+#include "classifier/exercise_registry.h"
+#include "classifier/pose_classification.h"
+#include "mediapipe/pose_detection_interpreter.h"
+#include "mediapipe/pose_landmark_interpreter.h"
+#include "utils/ema_filter.h"
+#include "utils/pose_roi.h"
+
+static std::atomic<bool> counting{false};
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  if (counting)
+    allocations++;
+  void *pointer = malloc(size > 0 ? size : 1);
+  if (pointer == nullptr)
+    throw std::bad_alloc();
+  return pointer;
+}
+
+void operator delete(void *pointer) noexcept { free(pointer); }
+
+void operator delete(void *pointer, size_t size) noexcept {
+  (void)size;
+  free(pointer);
+}
+
+// Model outputs, as negotiated by NNStreamer
+static const int DETECTION_INPUT_SIZE = 224;
+static const int LANDMARK_INPUT_SIZE = 256;
+static const size_t NUM_DETECTIONS = 2254;
+static const size_t DETECTION_VALUES = 12;
+static const size_t NUM_LANDMARKS = 39;
+static const size_t LANDMARK_VALUES = 5;
+
+static const int WIDTH = 640;
+static const int HEIGHT = 480;
+static const size_t WARM_UP_FRAMES = 50;
+static const size_t TEST_FRAMES = 1000;
+// Every n-th frame has a landmark score below the threshold
+static const size_t NO_POSE_PERIOD = 25;
+
+/**
+ * Function to load the landmarks of the pose samples, 33 x, y, z per sample
+ */
+static std::vector<std::vector<float>> load_landmarks(const char *file) {
+  std::vector<std::vector<float>> samples;
+  std::ifstream file_in(file);
+  std::string line, word;
+  while (getline(file_in, line)) {
+    std::vector<float> values;
+    std::stringstream str(line);
+    for (size_t column{0}; getline(str, word, ','); column++) {
+      if (column >= 2)
+        values.push_back(std::stof(word));
+    }
+    if (values.size() == 33 * 3)
+      samples.push_back(values);
+  }
+  return samples;
+}
+
+/**
+ * Function to find the anchors closest to the center of the frame
+ */
+static size_t find_center_anchor() {
+  size_t center = 0;
+  float min_distance = 2.0;
+  for (size_t i{0}; i < POSE_DETECTION_ANCHORS.size(); i++) {
+    float distance = std::abs(POSE_DETECTION_ANCHORS.x_center[i] - 0.5) +
+                     std::abs(POSE_DETECTION_ANCHORS.y_center[i] - 0.5);
+    if (distance < min_distance) {
+      min_distance = distance;
+      center = i;
+    }
+  }
+  return center;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " pose_embeddings.csv\n";
+    return 1;
+  }
+  std::vector<std::vector<float>> samples = load_landmarks(argv[1]);
+  if (samples.empty()) {
+    std::cerr << "No pose samples in " << argv[1] << "\n";
+    return 1;
+  }
+
+  PoseDetectionInterpreter detection;
+  PoseLandmarkInterpreter landmark_interpreter;
+  if (!detection.configure(
+          {{"boxes", {DETECTION_VALUES, NUM_DETECTIONS, 1}, true,
+            NUM_DETECTIONS * DETECTION_VALUES * sizeof(float)},
+           {"scores", {1, NUM_DETECTIONS, 1}, true,
+            NUM_DETECTIONS * sizeof(float)}},
+          DETECTION_INPUT_SIZE) ||
+      !landmark_interpreter.configure(
+          {{"landmarks", {NUM_LANDMARKS * LANDMARK_VALUES, 1}, true,
+            NUM_LANDMARKS * LANDMARK_VALUES * sizeof(float)},
+           {"score", {1, 1}, true, sizeof(float)}},
+          LANDMARK_INPUT_SIZE))
+    return 1;
+
+  PoseClassifier classifier(argv[1]);
+  ExerciseRegistry registry;
+  ExerciseEngine engine(&classifier, registry);
+  Filter filter_bbox;
+  Filter filter_landmark;
+
+  std::vector<float> boxes(NUM_DETECTIONS * DETECTION_VALUES, 0.0);
+  std::vector<float> scores(NUM_DETECTIONS, -10.0);
+  std::vector<float> raw_landmarks(NUM_LANDMARKS * LANDMARK_VALUES, 5.0);
+  Keypoint padded_size(WIDTH, WIDTH);
+  size_t center = find_center_anchor();
+  size_t poses = 0;
+  size_t counted = 0;
+  int repetitions = engine.get_repetitions(0);
+
+  for (size_t frame{0}; frame < WARM_UP_FRAMES + TEST_FRAMES; frame++) {
+    if (frame == WARM_UP_FRAMES)
+      counting = true;
+
+    // Overlapping detections around the center, suppressed by NMS
+    float jitter = (frame % 7) - 3.0;
+    for (size_t i{center}; i < center + 4 && i < NUM_DETECTIONS; i++) {
+      float *box = &boxes[i * DETECTION_VALUES];
+      box[0] = jitter + (i - center);
+      box[1] = jitter;
+      box[2] = 100.0;
+      box[3] = 160.0;
+      box[4] = jitter;
+      box[5] = 20.0;
+      box[6] = jitter;
+      box[7] = -60.0;
+      scores[i] = 2.0 + 0.5 * (i - center);
+    }
+    detection.decode_predictions(boxes.data(), scores.data());
+    BoundingBox roi;
+    if (get_pose_roi(detection.get_pose_detections(), padded_size, WIDTH,
+                     HEIGHT, roi))
+      filter_bbox.filter(roi);
+
+    // Landmarks of the pose samples in turn
+    const std::vector<float> &sample = samples[frame % samples.size()];
+    for (size_t i{0}; i < 33; i++) {
+      for (size_t k{0}; k < 3; k++)
+        raw_landmarks[i * LANDMARK_VALUES + k] = sample[i * 3 + k];
+    }
+    float score = (frame % NO_POSE_PERIOD == 0) ? -5.0 : 5.0;
+
+    ClassificationResult result;
+    if (landmark_interpreter.decode_predictions(raw_landmarks.data(), score)) {
+      Landmark landmark = landmark_interpreter.get_pose_landmark();
+      if (engine.is_visible(landmark)) {
+        Landmark filtered = filter_landmark.filter(landmark);
+        result = engine.classify(filtered);
+        poses += counting ? 1 : 0;
+      } else {
+        result = engine.classify_empty();
+      }
+    } else {
+      result = engine.classify_empty();
+    }
+    engine.count(result);
+    if (engine.get_repetitions(0) != repetitions) {
+      repetitions = engine.get_repetitions(0);
+      counted++;
+    }
+  }
+  counting = false;
+
+  std::cout << allocations << " allocations over " << TEST_FRAMES
+            << " frames, " << poses << " poses classified, " << counted
+            << " repetitions counted\n";
+  if (poses == 0 || counted == 0) {
+    std::cerr << "Frames were not classified and counted\n";
+    return 1;
+  }
+  return (allocations == 0) ? 0 : 1;
+}